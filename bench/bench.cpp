@@ -0,0 +1,436 @@
+/**
+ * Micro-benchmarks of the data processing kernels of inpreCICE
+ *
+ * Every benchmark runs on a smooth synthetic field for each of the given
+ * grid sizes. After one warm-up run, the wall clock time of the given number
+ * of repetitions is measured and summarized as minimum, median and mean.
+ * The results are printed as a table and can be written to a CSV or JSON
+ * file for comparing them over time.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <boost/multi_array.hpp>
+
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+#include <json.hpp>
+using json = nlohmann::json;
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "draw/util/util.hpp"
+#include "draw/util/transferfunc.hpp"
+#include "adapter/conversion.hpp"
+#include "adapter/vismesh.hpp"
+
+//-----------------------------------------------------------------------------
+// types
+//-----------------------------------------------------------------------------
+struct BenchSettings
+{
+    std::vector<size_t> gridSizes;
+    size_t repetitions;
+    size_t maxMeshGridSize;
+    std::string filter;
+    std::string outputFile;
+    std::string tmpDir;
+
+    BenchSettings() :
+        gridSizes({10, 64, 256, 1024, 4096}),
+        repetitions(10),
+        maxMeshGridSize(1024),
+        filter(),
+        outputFile(),
+        tmpDir("/tmp")
+    {}
+};
+
+struct BenchResult
+{
+    std::string name;
+    size_t gridSize;
+    size_t numItems;
+    std::vector<double> times;  //!< wall clock time of each repetition in s
+
+    double getMin() const
+    {
+        return *std::min_element(times.cbegin(), times.cend());
+    }
+    double getMedian() const
+    {
+        std::vector<double> sorted(times);
+        std::sort(sorted.begin(), sorted.end());
+        const size_t n = sorted.size();
+        return (n % 2) ? sorted[n / 2]
+            : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+    }
+    double getMean() const
+    {
+        return std::accumulate(times.cbegin(), times.cend(), 0.) /
+            times.size();
+    }
+};
+
+using field_t = boost::multi_array<float, 2>;
+
+//-----------------------------------------------------------------------------
+// function prototypes
+//-----------------------------------------------------------------------------
+int applyProgramOptions(int argc, char *argv[], BenchSettings &settings);
+field_t createField(size_t gridSize);
+void writeVisMesh(const std::string &path, size_t gridSize);
+void printResult(const BenchResult &result);
+int writeResults(
+        const std::string &path, const std::vector<BenchResult> &results);
+
+//-----------------------------------------------------------------------------
+// globals
+//-----------------------------------------------------------------------------
+// results are accumulated here so the compiler can not drop the work
+volatile size_t g_sink = 0;
+
+//-----------------------------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------------------------
+/**
+ * \brief Runs a benchmark once for warming up and then measures it
+ */
+BenchResult runBenchmark(
+        const std::string &name,
+        size_t gridSize,
+        size_t numItems,
+        size_t repetitions,
+        const std::function<size_t()> &kernel)
+{
+    BenchResult result{name, gridSize, numItems, {}};
+
+    g_sink += kernel();
+    for (size_t i = 0; i < repetitions; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        g_sink += kernel();
+        const auto end = std::chrono::steady_clock::now();
+        result.times.push_back(
+            std::chrono::duration<double>(end - start).count());
+    }
+
+    printResult(result);
+    return result;
+}
+
+/**
+ * \brief Main entry point of the benchmarks
+ */
+int main(int argc, char *argv[])
+{
+    BenchSettings settings;
+    if (EXIT_FAILURE == applyProgramOptions(argc, argv, settings))
+    {
+        std::cout << "Error: Parsing of program options failed!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto isSelected = [&settings](const std::string &name) {
+        return name.find(settings.filter) != std::string::npos;
+    };
+
+#ifdef _OPENMP
+    std::cout << "OpenMP threads: " << omp_get_max_threads() << "\n";
+#endif
+    std::cout << std::left << std::setw(36) << "benchmark"
+        << std::right << std::setw(8) << "grid"
+        << std::setw(12) << "min [ms]"
+        << std::setw(12) << "median [ms]"
+        << std::setw(12) << "mean [ms]"
+        << std::setw(14) << "Mitems/s" << std::endl;
+
+    // isovalues as used by the renderer by default
+    std::vector<float> isovalues;
+    for (size_t i = 1; i < 10; ++i)
+        isovalues.push_back(0.1f * i);
+
+    std::vector<BenchResult> results;
+    for (const size_t n : settings.gridSizes)
+    {
+        const size_t numPoints = n * n;
+        const field_t field = createField(n);
+        field_t fieldCopy(field);
+
+        if (isSelected("extractIsolines"))
+            results.push_back(runBenchmark(
+                "extractIsolines", n, numPoints, settings.repetitions,
+                [&]() {
+                    return util::extractIsolines(field, isovalues).size();
+                }));
+
+        util::MinMaxPyramid<float> pyramid;
+        if (isSelected("MinMaxPyramid::build"))
+            results.push_back(runBenchmark(
+                "MinMaxPyramid::build", n, numPoints, settings.repetitions,
+                [&]() {
+                    pyramid.build(field);
+                    return size_t(1);
+                }));
+
+        if (isSelected("extractIsolines/pyramid"))
+        {
+            pyramid.build(field);
+            results.push_back(runBenchmark(
+                "extractIsolines/pyramid", n, numPoints,
+                settings.repetitions,
+                [&]() {
+                    return util::extractIsolines(
+                        field, isovalues, pyramid).size();
+                }));
+        }
+
+        if (isSelected("binData"))
+            results.push_back(runBenchmark(
+                "binData", n, numPoints, settings.repetitions,
+                [&]() {
+                    return util::binData(
+                        256, 0.f, 1.f, fieldCopy.data(), numPoints).size();
+                }));
+
+        // the resolution of the discretization scales with the grid
+        if (isSelected("TransferFuncRGBA1D::getDiscretized"))
+        {
+            util::tf::TransferFuncRGBA1D tf;
+            results.push_back(runBenchmark(
+                "TransferFuncRGBA1D::getDiscretized", n, n,
+                settings.repetitions,
+                [&]() {
+                    return tf.getDiscretized(0.f, 255.f, n).size();
+                }));
+        }
+
+        if (isSelected("convertToFloat"))
+        {
+            const std::vector<double> values(
+                field.data(), field.data() + numPoints);
+            results.push_back(runBenchmark(
+                "convertToFloat", n, numPoints, settings.repetitions,
+                [&]() {
+                    inpreciceadapter::convertToFloat(
+                        values.data(), numPoints, fieldCopy.data());
+                    return size_t(fieldCopy.data()[numPoints - 1] > 0.f);
+                }));
+        }
+
+        if (isSelected("VisMeshFile::open/json") &&
+                (n <= settings.maxMeshGridSize))
+        {
+            const std::string path = settings.tmpDir +
+                "/inpreCICE-bench-" + std::to_string(n) + ".json";
+            writeVisMesh(path, n);
+            results.push_back(runBenchmark(
+                "VisMeshFile::open/json", n, numPoints, settings.repetitions,
+                [&]() {
+                    inpreciceadapter::VisMeshFile meshFile;
+                    meshFile.open(path, 1);
+                    return meshFile.getMeshes().size();
+                }));
+            std::remove(path.c_str());
+        }
+    }
+
+    if (!settings.outputFile.empty())
+        return writeResults(settings.outputFile, results);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * \brief Creates a smooth field with values in [0, 1] and many isolines
+ */
+field_t createField(size_t gridSize)
+{
+    field_t field(boost::extents[gridSize][gridSize]);
+    const float scale = 6.f / static_cast<float>(gridSize);
+    for (size_t y = 0; y < gridSize; ++y)
+        for (size_t x = 0; x < gridSize; ++x)
+            field[y][x] = 0.5f + 0.25f * std::sin(scale * x) +
+                0.25f * std::cos(scale * y + 0.5f * std::sin(scale * x));
+
+    return field;
+}
+
+/**
+ * \brief Writes a case 1 vis-mesh file with a regular grid
+ *
+ * The edges written by mesh-generator.py are left out, the loader skips
+ * them anyway.
+ */
+void writeVisMesh(const std::string &path, size_t gridSize)
+{
+    std::ofstream fs(path.c_str());
+    fs << "{\"case1\": {\"gridNumDimensions\": 2, \"posNumDimensions\": 3, "
+        << "\"gridDimensions\": [" << gridSize << ", " << gridSize << "], "
+        << "\"mappingData\": \"Concentration\", \"vertices\": [";
+    const double spacing = 100. / static_cast<double>(gridSize);
+    for (size_t y = 0; y < gridSize; ++y)
+        for (size_t x = 0; x < gridSize; ++x)
+        {
+            fs << ((x + y > 0) ? ", " : "")
+                << "{\"idx\": " << y * gridSize + x << ", \"pos\": ["
+                << (x + 0.5) * spacing << ", " << (y + 0.5) * spacing
+                << ", 80.0]}";
+        }
+    fs << "]}}\n";
+}
+
+/**
+ * \brief Prints one line of the result table
+ */
+void printResult(const BenchResult &result)
+{
+    const double median = result.getMedian();
+    std::cout << std::left << std::setw(36) << result.name
+        << std::right << std::setw(8) << result.gridSize
+        << std::fixed << std::setprecision(3)
+        << std::setw(12) << 1e3 * result.getMin()
+        << std::setw(12) << 1e3 * median
+        << std::setw(12) << 1e3 * result.getMean()
+        << std::setw(14) << std::setprecision(1)
+        << ((median > 0.) ? 1e-6 * result.numItems / median : 0.)
+        << std::defaultfloat << std::endl;
+}
+
+/**
+ * \brief Writes the results as CSV or, for files ending in .json, as JSON
+ *
+ * \return  EXIT_SUCCESS or EXIT_FAILURE if the file could not be written
+ */
+int writeResults(
+        const std::string &path, const std::vector<BenchResult> &results)
+{
+    std::ofstream fs(path.c_str());
+    if (!fs.good())
+    {
+        std::cout << "Error: Could not write " << path << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const bool isJson = (path.size() >= 5) &&
+        (path.compare(path.size() - 5, 5, ".json") == 0);
+    if (isJson)
+    {
+        json benchmarks = json::array();
+        for (const BenchResult &result : results)
+            benchmarks.push_back({
+                {"name", result.name},
+                {"grid_size", result.gridSize},
+                {"items", result.numItems},
+                {"repetitions", result.times.size()},
+                {"min_s", result.getMin()},
+                {"median_s", result.getMedian()},
+                {"mean_s", result.getMean()},
+                {"times_s", result.times}
+            });
+
+        json root;
+#ifdef _OPENMP
+        root["threads"] = omp_get_max_threads();
+#else
+        root["threads"] = 1;
+#endif
+        root["benchmarks"] = benchmarks;
+        fs << root.dump(4) << std::endl;
+    }
+    else
+    {
+        fs << "name,grid_size,items,repetitions,min_s,median_s,mean_s\n";
+        fs << std::setprecision(9);
+        for (const BenchResult &result : results)
+            fs << result.name << ',' << result.gridSize << ','
+                << result.numItems << ',' << result.times.size() << ','
+                << result.getMin() << ',' << result.getMedian() << ','
+                << result.getMean() << '\n';
+    }
+
+    std::cout << "Results were written to " << path << std::endl;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * \brief Parses the program options of the benchmarks
+ *
+ * \return  EXIT_SUCCESS or EXIT_FAILURE depending on success of parsing the
+ *          program arguments
+ */
+int applyProgramOptions(int argc, char *argv[], BenchSettings &settings)
+{
+    po::options_description generic("Options");
+    generic.add_options()
+        ("help,h", "produce help message")
+        ("sizes,s",
+         po::value< std::vector<size_t> >()->multitoken(),
+         "grid sizes n of the n x n fields (default: 10 64 256 1024 4096)")
+        ("repetitions,n",
+         po::value<size_t>(),
+         "measured runs per benchmark and grid size (default: 10)")
+        ("filter,f",
+         po::value<std::string>(),
+         "only run benchmarks whose name contains the given text")
+        ("max-mesh-grid",
+         po::value<size_t>(),
+         "largest grid size for loading vis-mesh files, which are written "
+         "to the temporary directory first (default: 1024)")
+        ("tmp-dir",
+         po::value<std::string>(),
+         "directory for temporary files (default: /tmp)")
+        ("output,o",
+         po::value<std::string>(),
+         "write the results to the given .csv or .json file")
+    ;
+
+    try
+    {
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, generic), vm);
+        po::notify(vm);
+
+        if (vm.count("help"))
+        {
+            std::cout << "Usage: inpreCICE-bench [options]\n" << std::endl;
+            std::cout << generic << std::endl;
+            exit(EXIT_SUCCESS);
+        }
+
+        if (vm.count("sizes") > 0)
+            settings.gridSizes = vm["sizes"].as< std::vector<size_t> >();
+        if (vm.count("repetitions") > 0)
+            settings.repetitions =
+                std::max<size_t>(1, vm["repetitions"].as<size_t>());
+        if (vm.count("filter") > 0)
+            settings.filter = vm["filter"].as<std::string>();
+        if (vm.count("max-mesh-grid") > 0)
+            settings.maxMeshGridSize = vm["max-mesh-grid"].as<size_t>();
+        if (vm.count("tmp-dir") > 0)
+            settings.tmpDir = vm["tmp-dir"].as<std::string>();
+        if (vm.count("output") > 0)
+            settings.outputFile = vm["output"].as<std::string>();
+    }
+    catch(std::exception &e)
+    {
+        std::cout << "Invalid program options!" << std::endl;
+        std::cout << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
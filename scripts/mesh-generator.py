@@ -46,25 +46,41 @@ def makeRegularPlane3D(
 
     return vertices, edges
 
-def generateCase1():
+def makePlaneMesh(
+        p: np.ndarray,
+        u: np.ndarray,
+        v: np.ndarray,
+        gridSize: Tuple[int, int],
+        parametric: bool
+        ) -> Dict:
+    if parametric:
+        # vertices are generated by the adapter from the plane parameters
+        return {'plane' : {
+            'p' : p.tolist(),
+            'u' : u.tolist(),
+            'v' : v.tolist()}}
+
+    vertices, edges = makeRegularPlane3D(p, u, v, gridSize)
+    return {'vertices' : vertices, 'edges' : edges}
+
+def generateCase1(gridDim: List[int], parametric: bool):
     data = {
             'gridNumDimensions' : 2,
             'posNumDimensions' : 3,
-            'gridDimensions' : [10, 10],
+            'gridDimensions' : gridDim,
             'mappingData' : 'Concentration'}
-    vertices, edges = makeRegularPlane3D(
+    data.update(makePlaneMesh(
             np.array([5, 5, 77]),
             np.array([90, 0, -54]),
             np.array([0, 90, 0]),
-            data['gridDimensions'])
-    data.update(vertices=vertices, edges=edges)
+            data['gridDimensions'],
+            parametric))
 
     return data
 
-def generateCase2():
+def generateCase2(gridDim: List[int], parametric: bool):
     data = dict()
 
-    gridDim = [10, 10]
     for i in range(9):
         frac = {
             'gridNumDimensions' : 2,
@@ -73,68 +89,68 @@ def generateCase2():
             'mappingData' : 'Concentration' + str(i) }
         data.update({'VisualizationMesh' + str(i) : frac})
 
-    vertices, edges = makeRegularPlane3D(
+    data['VisualizationMesh0'].update(makePlaneMesh(
             np.array([0.5, 0, 0]),
             np.array([0, 1, 0]),
             np.array([0, 0, 1]),
-            gridDim)
-    data['VisualizationMesh0'].update(vertices=vertices, edges=edges)
+            gridDim,
+            parametric))
 
-    vertices, edges = makeRegularPlane3D(
+    data['VisualizationMesh1'].update(makePlaneMesh(
             np.array([0, 0.5, 0]),
             np.array([1, 0, 0]),
             np.array([0, 0, 1]),
-            gridDim)
-    data['VisualizationMesh1'].update(vertices=vertices, edges=edges)
+            gridDim,
+            parametric))
 
-    vertices, edges = makeRegularPlane3D(
+    data['VisualizationMesh2'].update(makePlaneMesh(
             np.array([0, 0, 0.5]),
             np.array([1, 0, 0]),
             np.array([0, 1, 0]),
-            gridDim)
-    data['VisualizationMesh2'].update(vertices=vertices, edges=edges)
+            gridDim,
+            parametric))
 
-    vertices, edges = makeRegularPlane3D(
+    data['VisualizationMesh3'].update(makePlaneMesh(
             np.array([0.75, 0.5, 0.5]),
             np.array([0, 0.5, 0]),
             np.array([0, 0, 0.5]),
-            gridDim)
-    data['VisualizationMesh3'].update(vertices=vertices, edges=edges)
+            gridDim,
+            parametric))
 
-    vertices, edges = makeRegularPlane3D(
+    data['VisualizationMesh4'].update(makePlaneMesh(
             np.array([0.5, 0.5, 0.75]),
             np.array([0.5, 0, 0]),
             np.array([0, 0.5, 0]),
-            gridDim)
-    data['VisualizationMesh4'].update(vertices=vertices, edges=edges)
+            gridDim,
+            parametric))
 
-    vertices, edges = makeRegularPlane3D(
+    data['VisualizationMesh5'].update(makePlaneMesh(
             np.array([0.5, 0.75, 0.5]),
             np.array([0.5, 0, 0]),
             np.array([0, 0, 0.5]),
-            gridDim)
-    data['VisualizationMesh5'].update(vertices=vertices, edges=edges)
+            gridDim,
+            parametric))
 
-    vertices, edges = makeRegularPlane3D(
+    data['VisualizationMesh6'].update(makePlaneMesh(
             np.array([0.5, 0.625, 0.5]),
             np.array([0.25, 0, 0]),
             np.array([0, 0, 0.25]),
-            gridDim)
-    data['VisualizationMesh6'].update(vertices=vertices, edges=edges)
+            gridDim,
+            parametric))
 
-    vertices, edges = makeRegularPlane3D(
+    data['VisualizationMesh7'].update(makePlaneMesh(
             np.array([0.625, 0.5, 0.5]),
             np.array([0, 0.25, 0]),
             np.array([0, 0, 0.25]),
-            gridDim)
-    data['VisualizationMesh7'].update(vertices=vertices, edges=edges)
+            gridDim,
+            parametric))
 
-    vertices, edges = makeRegularPlane3D(
+    data['VisualizationMesh8'].update(makePlaneMesh(
             np.array([0.5, 0.5, 0.625]),
             np.array([0.25, 0, 0]),
             np.array([0, 0.25, 0]),
-            gridDim)
-    data['VisualizationMesh8'].update(vertices=vertices, edges=edges)
+            gridDim,
+            parametric))
 
     return data
 
@@ -149,6 +165,21 @@ if __name__ == '__main__':
         dest='file',
         help='path where the generated json-file is written to')
 
+    parser.add_argument(
+        '--grid-dimensions',
+        metavar=('NX', 'NY'),
+        type=int,
+        nargs=2,
+        default=[10, 10],
+        dest='gridDim',
+        help='number of vertices of each visualization mesh (default: 10 10)')
+    parser.add_argument(
+        '--parametric',
+        action='store_true',
+        help=(
+            'describe the meshes by plane parameters instead of listing '
+            'all vertices and edges'))
+
     args = parser.parse_args()
 
     # get target path
@@ -162,8 +193,8 @@ if __name__ == '__main__':
             exit(0)
 
     meshes = dict()
-    meshes['case1'] = generateCase1()
-    meshes['case2'] = generateCase2()
+    meshes['case1'] = generateCase1(args.gridDim, args.parametric)
+    meshes['case2'] = generateCase2(args.gridDim, args.parametric)
 
     writeVisMeshes(args.file, meshes)
     print('Wrote mesh file', args.file)
@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+
+import sys
+import os
+import json
+import struct
+import argparse
+import numpy as np
+from typing import Dict, List, Tuple
+
+# binary container layout, see src/adapter/vismesh.hpp
+MAGIC = b'IPCVMESH'
+VERSION = 1
+HEADER_FORMAT = '<8sII'
+MESH_ENTRY_FORMAT = '<IIQQQQQQ'
+
+def readJsonMeshes(path: str) -> List[Tuple[int, str, Dict]]:
+    with open(path, 'r') as f:
+        conf = json.load(f)
+
+    meshes = list()
+    if 'case1' in conf:
+        meshes.append((1, 'VisualizationMesh', conf['case1']))
+    if 'case2' in conf:
+        # the adapter orders the meshes of a case by name
+        for name in sorted(conf['case2'].keys()):
+            meshes.append((2, name, conf['case2'][name]))
+
+    return meshes
+
+def getDataNames(mesh: Dict) -> List[str]:
+    names = mesh['mappingData']
+    if isinstance(names, str):
+        return [names]
+    return list(names)
+
+def makePlaneVertices(mesh: Dict) -> np.ndarray:
+    # same vertex order and evaluation order as makeRegularPlane3D in
+    # mesh-generator.py
+    p, u, v = (
+        np.array(mesh['plane'][k], dtype='<f8') for k in ('p', 'u', 'v'))
+    nx, ny = mesh['gridDimensions']
+    mx = u / (nx - 1) if nx > 1 else np.zeros(3)
+    my = v / (ny - 1) if ny > 1 else np.zeros(3)
+    ix = np.tile(np.arange(nx), ny)[:, np.newaxis]
+    iy = np.repeat(np.arange(ny), nx)[:, np.newaxis]
+    return (p + ix * mx) + iy * my
+
+def getVertices(mesh: Dict) -> np.ndarray:
+    if 'vertices' not in mesh:
+        return makePlaneVertices(mesh)
+
+    numVertices = mesh['gridDimensions'][0] * mesh['gridDimensions'][1]
+    vertices = np.array(
+        [v['pos'] for v in mesh['vertices'][:numVertices]],
+        dtype='<f8')
+    if vertices.shape != (numVertices, 3):
+        raise ValueError('mesh contains too few vertices')
+    return vertices
+
+def align(offset: int, alignment: int) -> int:
+    return (offset + alignment - 1) // alignment * alignment
+
+def writeBinaryMeshes(path: str, meshes: List[Tuple[int, str, Dict]]):
+    headerSize = struct.calcsize(HEADER_FORMAT)
+    entrySize = struct.calcsize(MESH_ENTRY_FORMAT)
+
+    # zero terminated strings follow directly behind the mesh table
+    offset = headerSize + len(meshes) * entrySize
+    strings = bytearray()
+    stringOffsets = list()
+    for bmCase, name, mesh in meshes:
+        nameOffset = offset + len(strings)
+        strings += name.encode('utf-8') + b'\0'
+        dataNamesOffset = offset + len(strings)
+        for dataName in getDataNames(mesh):
+            strings += dataName.encode('utf-8') + b'\0'
+        stringOffsets.append((nameOffset, dataNamesOffset))
+
+    # vertex blocks are 8 byte aligned so they can be used in place
+    offset = align(offset + len(strings), 8)
+    vertexBlocks = list()
+    vertexOffsets = list()
+    for bmCase, name, mesh in meshes:
+        vertices = getVertices(mesh)
+        vertexOffsets.append(offset)
+        vertexBlocks.append(vertices)
+        offset += vertices.nbytes
+
+    with open(path, 'wb') as f:
+        f.write(struct.pack(HEADER_FORMAT, MAGIC, VERSION, len(meshes)))
+        for i, (bmCase, name, mesh) in enumerate(meshes):
+            f.write(struct.pack(
+                MESH_ENTRY_FORMAT,
+                bmCase,
+                len(getDataNames(mesh)),
+                mesh['gridDimensions'][0],
+                mesh['gridDimensions'][1],
+                stringOffsets[i][0],
+                stringOffsets[i][1],
+                vertexOffsets[i],
+                0))
+        f.write(strings)
+        f.write(b'\0' * (align(f.tell(), 8) - f.tell()))
+        for vertices in vertexBlocks:
+            f.write(vertices.tobytes())
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(
+        description=(
+            'Convert a json-file written by mesh-generator.py into the '
+            'binary visualization mesh format that is memory-mapped by '
+            'inpreCICE.'))
+    parser.add_argument(
+        metavar='input-file',
+        type=str,
+        dest='input',
+        help='path of the json-file describing the visualization meshes')
+    parser.add_argument(
+        metavar='output-file',
+        type=str,
+        dest='file',
+        help='path where the binary mesh file is written to')
+
+    args = parser.parse_args()
+
+    if not os.path.exists(args.input):
+        print('Error: input file does not exist!')
+        exit(1)
+
+    # get target path
+    outputDir = os.path.dirname(args.file)
+    if outputDir and not os.path.exists(outputDir):
+        print('Error: output directory does not exist!')
+        exit(1)
+
+    if os.path.exists(args.file):
+        text = input('Overwrite ' + args.file + ' ? [y/N] ')
+        if text.lower() not in ['yes', 'y']:
+            exit(0)
+
+    writeBinaryMeshes(args.file, readJsonMeshes(args.input))
+    print('Wrote mesh file', args.file)
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+namespace inpreciceadapter {
+namespace binaryio {
+
+/**
+ * \brief Tells whether the host stores values in big endian byte order
+ */
+inline bool isBigEndianHost()
+{
+    const uint16_t probe = 1;
+    uint8_t firstByte;
+    std::memcpy(&firstByte, &probe, sizeof(firstByte));
+    return 0 == firstByte;
+}
+
+/**
+ * \brief Reads a trivially copyable value stored in little endian byte
+ *        order from an unaligned file position
+ *
+ * Throws std::runtime_error if the value lies outside of the data.
+ */
+template<typename T>
+T readValue(const char* data, size_t size, size_t offset)
+{
+    if ((offset > size) || (sizeof(T) > size - offset))
+        throw std::runtime_error("File is truncated");
+
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, data + offset, sizeof(T));
+    if (isBigEndianHost())
+        std::reverse(bytes, bytes + sizeof(T));
+
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+/**
+ * \brief Writes a trivially copyable value in little endian byte order
+ */
+template<typename T>
+void writeValue(std::ostream& os, const T& value)
+{
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    if (isBigEndianHost())
+        std::reverse(bytes, bytes + sizeof(T));
+
+    os.write(bytes, sizeof(T));
+}
+
+} //namespace binaryio
+} //namespace inpreciceadapter
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+namespace inpreciceadapter {
+
+/**
+ * \brief Converts coupling data to single precision for the renderer
+ */
+inline void convertToFloat(const double* src, size_t numValues, float* dst)
+{
+    #pragma omp simd
+    for (size_t i = 0; i < numValues; ++i)
+        dst[i] = static_cast<float>(src[i]);
+}
+
+} //namespace inpreciceadapter
@@ -0,0 +1,149 @@
+#include "datasource.hpp"
+#include "recording.hpp"
+#include "trace/trace.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+using namespace inpreciceadapter;
+
+DataSource::DataSource() :
+    layout_(),
+    stopRequested_(false)
+{
+}
+
+DataSource::~DataSource()
+{
+    // derived sources have to stop the producer thread while they still exist
+    assert( !producerThread_.joinable() );
+}
+
+void DataSource::setHistoryLength(size_t length)
+{
+    assert( layout_.empty() );
+    publisher_.setHistoryLength(length);
+}
+
+void DataSource::setRecordingFile(const std::string& path)
+{
+    assert( layout_.empty() );
+    recordingPath_ = path;
+}
+
+void DataSource::setPublishCallback(std::function<void()> callback)
+{
+    publisher_.setPublishCallback(std::move(callback));
+}
+
+void DataSource::initialize()
+{
+    initializeSource(layout_);
+
+    // queued snapshots of the recorder and the one being written are not
+    // available for publishing
+    if (!recordingPath_.empty())
+        recorder_ = std::make_unique<Recorder>(recordingPath_, layout_);
+    publisher_.initialize(
+        layout_, recorder_ ? Recorder::QUEUE_CAPACITY + 1 : 0);
+}
+
+void DataSource::runThreaded()
+{
+    assert( !layout_.empty() );
+    producerThread_ = std::thread(&DataSource::runProducer, this);
+}
+
+void DataSource::runProducer()
+{
+    TRACE_THREAD_NAME("data source");
+    try
+    {
+        produce();
+    }
+    catch(std::exception &e)
+    {
+        std::cerr << "Error: Producing visualization data failed!"
+            << std::endl;
+        std::cerr << e.what() << std::endl;
+    }
+
+    if (recorder_)
+    {
+        recorder_->close();
+        if (recorder_->getNumDroppedSnapshots() > 0)
+            std::cerr << "Warning: " << recorder_->getNumDroppedSnapshots()
+                << " time steps were not recorded as writing to disk was "
+                "too slow!" << std::endl;
+    }
+
+    publisher_.finish();
+}
+
+void DataSource::publish()
+{
+    TRACE_SCOPE("publish");
+    const VisualizationSnapshotPtr_t published = publisher_.publish();
+    if (recorder_)
+        recorder_->push(published);
+}
+
+bool DataSource::waitUntil(std::chrono::steady_clock::time_point time)
+{
+    std::unique_lock<std::mutex> lock(stopMutex_);
+    return !stopCondition_.wait_until(
+        lock, time, [this](){ return stopRequested_; });
+}
+
+bool DataSource::isStopRequested()
+{
+    std::lock_guard<std::mutex> lock(stopMutex_);
+    return stopRequested_;
+}
+
+void DataSource::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(stopMutex_);
+        stopRequested_ = true;
+    }
+    stopCondition_.notify_all();
+
+    if (producerThread_.joinable())
+        producerThread_.join();
+}
+
+void DataSource::finalize()
+{
+    stop();
+    finalizeSource();
+}
+
+VisualizationSnapshotPtr_t DataSource::getVisualisationData() const
+{
+    return publisher_.getLatest();
+}
+
+VisualizationSnapshotPtr_t DataSource::getHistorySnapshot(
+        uint64_t version) const
+{
+    return publisher_.getHistorySnapshot(version);
+}
+
+uint64_t DataSource::getOldestHistoryVersion(uint64_t latestVersion) const
+{
+    return publisher_.getOldestHistoryVersion(latestVersion);
+}
+
+bool DataSource::isFinished() const
+{
+    return publisher_.isFinished();
+}
+
+bool DataSource::waitForData(
+        uint64_t version, std::chrono::milliseconds timeout) const
+{
+    return publisher_.waitForData(version, timeout);
+}
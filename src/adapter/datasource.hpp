@@ -0,0 +1,182 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "snapshot.hpp"
+
+namespace inpreciceadapter {
+
+class Recorder;
+
+/**
+ * \brief Provides time steps of visualization data to the renderer
+ *
+ * A data source produces time steps on a thread of its own and publishes
+ * them through a SnapshotPublisher, so readers never block the producer.
+ * Implementations only describe the meshes in initializeSource() and fill
+ * and publish snapshots in produce(). Keeping a history for browsing back in
+ * time and recording to disk work the same way for all sources.
+ */
+class DataSource
+{
+    public:
+    DataSource();
+    DataSource( const DataSource& ) = delete;
+    DataSource& operator=( const DataSource& ) = delete;
+    virtual ~DataSource();
+
+    /**
+     * \brief Sets the number of published snapshots that are kept for
+     *        browsing back in time
+     *
+     * Has to be called before initialize(), which preallocates all
+     * snapshots. A length of zero disables the history.
+     */
+    void setHistoryLength(size_t length);
+
+    /**
+     * \brief Records all published snapshots to the given file
+     *
+     * Has to be called before initialize(). The recording is written on its
+     * own thread and can be replayed with a ReplaySource.
+     */
+    void setRecordingFile(const std::string& path);
+
+    /**
+     * \brief Sets a function that is called on the producer thread whenever
+     *        a new snapshot was published or the source has finished
+     *
+     * Has to be set before runThreaded() is called.
+     */
+    void setPublishCallback(std::function<void()> callback);
+
+    /**
+     * \brief Sets up the meshes of the source and preallocates all snapshots
+     *
+     * Throws std::runtime_error if the source can not be set up.
+     */
+    void initialize();
+
+    /**
+     * \brief Meshes and data names of the source, valid after initialize()
+     */
+    const VisualizationDataInfoVec_t& getLayout() const { return layout_; }
+
+    /**
+     * \brief Starts producing time steps on a thread of its own
+     */
+    void runThreaded();
+
+    /**
+     * \brief Returns the most recently published time step
+     *
+     * The returned snapshot stays valid and unchanged as long as the caller
+     * holds the pointer. Safe to call concurrently to the producer thread.
+     */
+    VisualizationSnapshotPtr_t getVisualisationData() const;
+
+    /**
+     * \brief Returns the snapshot of the given version from the history
+     *
+     * \return the snapshot or nullptr if the version is not or no longer
+     *         kept in the history
+     */
+    VisualizationSnapshotPtr_t getHistorySnapshot(uint64_t version) const;
+
+    /**
+     * \brief Returns the oldest version kept in the history when the given
+     *        version is the latest one
+     */
+    uint64_t getOldestHistoryVersion(uint64_t latestVersion) const;
+
+    /**
+     * \brief Blocks until a snapshot newer than the given version was
+     *        published, the source has finished or the timeout expired
+     *
+     * \return false if the timeout expired, true otherwise
+     */
+    bool waitForData(
+            uint64_t version, std::chrono::milliseconds timeout) const;
+
+    /**
+     * \brief Returns true once the source has published its last time step
+     */
+    bool isFinished() const;
+
+    /**
+     * \brief Stops producing time steps, if the source supports it, waits
+     *        for the producer thread and shuts the source down
+     */
+    void finalize();
+
+    protected:
+    /**
+     * \brief Describes the meshes and data names of the source, the buffers
+     *        are only allocated in the snapshots (called by initialize())
+     */
+    virtual void initializeSource(VisualizationDataInfoVec_t& layout) = 0;
+
+    /**
+     * \brief Produces time steps until the source is exhausted or a stop was
+     *        requested (producer thread)
+     *
+     * Each time step is written to accessBackSnapshot() and then handed to
+     * the readers with publish().
+     */
+    virtual void produce() = 0;
+
+    /**
+     * \brief Shuts the source down after the producer thread has finished
+     *        (called by finalize())
+     */
+    virtual void finalizeSource() {}
+
+    VisualizationSnapshot& accessBackSnapshot()
+    {
+        return publisher_.accessBackSnapshot();
+    }
+
+    /**
+     * \brief Publishes the back snapshot and queues it for recording
+     */
+    void publish();
+
+    /**
+     * \brief Waits until the given point in time for paced sources
+     *
+     * \return false if a stop was requested while waiting
+     */
+    bool waitUntil(std::chrono::steady_clock::time_point time);
+
+    bool isStopRequested();
+
+    /**
+     * \brief Requests a stop and waits for the producer thread, has to be
+     *        called by the destructors of sources that can be stopped
+     */
+    void stop();
+
+    private:
+    VisualizationDataInfoVec_t layout_;
+    SnapshotPublisher publisher_;
+
+    // Optional recording of all published snapshots to disk
+    std::string recordingPath_;
+    std::unique_ptr<Recorder> recorder_;
+
+    std::thread producerThread_;
+    bool stopRequested_;
+    std::mutex stopMutex_;
+    std::condition_variable stopCondition_;
+
+    void runProducer();
+};
+
+} //namespace inpreciceadapter
@@ -1,38 +1,14 @@
 #include "inpreciceadapter.hpp"
+#include "vismesh.hpp"
+#include "conversion.hpp"
+#include "trace/trace.hpp"
 
 #include <precice/SolverInterface.hpp>
 
+#include <algorithm>
 #include <cassert>
-#include <iostream>
-#include <fstream>
-#include <thread>
 #include <string>
 
-#include <json.hpp>
-using json = nlohmann::json;
-
-std::ostream& inpreciceadapter::operator<<(
-        std::ostream& os,
-        const VisualizationDataInfo& info )
-{
-    os << "  Mesh id: "   << info.meshID << "\n"
-        << "  Mesh name: "  << info.meshName << "\n"
-        << "  Mesh dim: " << info.gridDimension[0] << " x "
-            << info.gridDimension[1] << "\n"
-        << "  #Vertices: " << info.vertexIDs.size() << "\n"
-        << std::endl;
-
-    os << "Data names:" << std::endl;
-
-    assert(info.dataIDs.size() == info.dataNames.size());
-    for (size_t i = 0; i < info.dataIDs.size(); ++i)
-        os << info.dataNames[i] << "(ID: " << info.dataIDs[i] << ")" << "\n";
-
-    os << std::endl;
-
-    return os;
-}
-
 using namespace inpreciceadapter;
 
 InpreciceAdapter::InpreciceAdapter(
@@ -45,164 +21,72 @@ InpreciceAdapter::InpreciceAdapter(
             std::make_unique<precice::SolverInterface>(
                 solverName, solverProcessRank, solverNumberOfProcesses) ),
         bmCase_(bmCase),
+        meshFilePath_(),
         preciceIsInitialized_(false),
         timeStepSize_(0.)
 {
     interface_->configure(configurationFileName);
 }
 
+void InpreciceAdapter::setVisualizationMesh(const std::string& meshFilePath)
+{
+    assert( !preciceIsInitialized_ );
+    meshFilePath_ = meshFilePath;
+}
+
 void InpreciceAdapter::initialize(const std::string& meshFilePath )
 {
-    json conf;
+    setVisualizationMesh(meshFilePath);
+    DataSource::initialize();
+}
+
+void InpreciceAdapter::initializeSource(VisualizationDataInfoVec_t& layout)
+{
+    if ((1 != bmCase_) && (2 != bmCase_))
     {
-        std::ifstream fs;
-        fs.open(meshFilePath.c_str(), std::ofstream::in);
-        fs >> conf;
-        fs.close();
+        // unimplemented benchmark case
+        return;
     }
 
-    if (1 == bmCase_)
-    {
-        conf = conf["case1"];
-        visInfoData_.resize(1);
-        VisualizationDataInfo &visInfo = visInfoData_[0];
+    // the vertices are handed to preCICE straight from the (memory mapped)
+    // mesh file, no intermediate copy is needed
+    VisMeshFile meshFile;
+    meshFile.open(meshFilePath_, bmCase_);
 
-        const std::string& meshName = "VisualizationMesh";
-        visInfo.meshName = meshName;
-        visInfo.meshID = interface_->getMeshID( meshName );
+    const std::vector<VisMesh>& meshes = meshFile.getMeshes();
+    visInfoData_.resize(meshes.size());
+    for (size_t m = 0; m < meshes.size(); ++m)
+    {
+        const VisMesh& mesh = meshes[m];
+        VisualizationDataInfo &visInfo = visInfoData_[m];
 
-        const size_t nDataFields = conf["mappingData"].size();
-        visInfo.buffers.resize(nDataFields);
+        visInfo.meshName = mesh.meshName;
+        visInfo.meshID = interface_->getMeshID( mesh.meshName );
 
-        auto& dataNames = visInfo.dataNames;
-        dataNames.reserve(nDataFields);
+        const size_t nDataFields = mesh.dataNames.size();
+        visInfo.dataNames = mesh.dataNames;
 
         auto& dataIDs = visInfo.dataIDs;
         dataIDs.reserve(nDataFields);
+        for (const auto& name: visInfo.dataNames)
+            dataIDs.push_back(interface_->getDataID(name, visInfo.meshID));
 
-        for (const auto& dataName: conf["mappingData"] )
-        {
-            const std::string name = dataName;
-            dataNames.push_back(name);
-            dataIDs.push_back(
-                interface_->getDataID(name, visInfo.meshID));
-        }
+        visInfo.gridDimension = mesh.gridDimension;
 
-        auto& gridDimension = visInfo.gridDimension;
-        gridDimension = conf["gridDimensions"].get<gridDimension_t>();
+        // the layout only describes the mesh, the vertex IDs stay here
+        layout.push_back(visInfo);
 
-        const std::size_t numPoints =
-                visInfo.gridDimension[0] * visInfo.gridDimension[1];
+        const std::size_t numPoints = mesh.getNumVertices();
         visInfo.vertexIDs.resize(numPoints);
 
-        std::for_each(
-            visInfo.buffers.begin(),
-            visInfo.buffers.end(),
-            [gridDimension](auto& buffer){
-                buffer.resize(
-                    boost::extents[gridDimension[0]][gridDimension[1]] );
-                      }
-            );
-
-        boost::multi_array<double, 2> gridPoints(boost::extents[numPoints][3]);
-        for (size_t idx = 0; idx < numPoints; ++idx)
-        {
-            gridPoints[idx][0] =
-                conf["vertices"][idx]["pos"].get<std::array<float, 3>>()[0];
-            gridPoints[idx][1] =
-                conf["vertices"][idx]["pos"].get<std::array<float, 3>>()[1];
-            gridPoints[idx][2] =
-                conf["vertices"][idx]["pos"].get<std::array<float, 3>>()[2];
-        }
-
         interface_->setMeshVertices(
             visInfo.meshID,
             static_cast<int>(numPoints),
-            gridPoints.data(),
+            mesh.vertices,
             visInfo.vertexIDs.data());
 
         assert(visInfo.vertexIDs.size() == numPoints);
-    }
-    else if (2 == bmCase_)
-    {
-        conf = conf["case2"];
-        {
-            visInfoData_.resize( conf.get<json::object_t>().size() );
-            size_t i = 0;
-            for (const auto& obj : conf.get<json::object_t>())
-            {
-                const std::string& meshName = obj.first;
-                visInfoData_[i].meshName = meshName;
-                visInfoData_[i].meshID = interface_->getMeshID( meshName );
-
-
-                const size_t nDataFields = conf[meshName]["mappingData"].size();
-                visInfoData_[i].buffers.resize( nDataFields );
-
-                auto& dataNames = visInfoData_[i].dataNames;
-                dataNames.reserve( nDataFields );
-
-                auto& dataIDs = visInfoData_[i].dataIDs;
-                dataIDs.reserve( nDataFields );
-
-                for (const auto& dataName: conf[meshName]["mappingData"] )
-                {
-                    const std::string name = dataName;
-                    dataNames.push_back(name);
-                    dataIDs.push_back(
-                        interface_->getDataID(name, visInfoData_[i].meshID ));
-                }
-                ++i;
-            }
-        }
-
-        for (auto& visInfo: visInfoData_ )
-        {
-            const std::string& meshName = visInfo.meshName;
-            auto& gridDimension = visInfo.gridDimension;
-            gridDimension = conf[meshName]["gridDimensions"].get<
-                    gridDimension_t>();
-
-            const std::size_t numPoints = visInfo.gridDimension[0] *
-                    visInfo.gridDimension[1];
-            visInfo.vertexIDs.resize(numPoints);
-
-            std::for_each(
-                visInfo.buffers.begin(),
-                visInfo.buffers.end(),
-                [gridDimension](auto& buffer){
-                    buffer.resize(
-                        boost::extents[gridDimension[0]][gridDimension[1]] );
-                          }
-                );
-
-            boost::multi_array<double, 2> gridPoints(boost::extents[numPoints][3]);
-            for (size_t idx = 0; idx < numPoints; ++idx)
-            {
-                gridPoints[idx][0] =
-                    conf[meshName]["vertices"][idx]["pos"].get<
-                        std::array<float, 3>>()[0];
-                gridPoints[idx][1] =
-                    conf[meshName]["vertices"][idx]["pos"].get<
-                        std::array<float, 3>>()[1];
-                gridPoints[idx][2] =
-                    conf[meshName]["vertices"][idx]["pos"].get<
-                        std::array<float, 3>>()[2];
-            }
-
-            interface_->setMeshVertices(
-                visInfo.meshID,
-                static_cast<int>(numPoints),
-                gridPoints.data(),
-                visInfo.vertexIDs.data());
-
-            assert( visInfo.vertexIDs.size() == numPoints );
-        }
-    }
-    else
-    {
-        // unimplemented benchmark case
-        return;
+        readBuffer_.resize(std::max(readBuffer_.size(), numPoints));
     }
 
     timeStepSize_ = interface_->initialize();
@@ -212,53 +96,50 @@ void InpreciceAdapter::initialize(const std::string& meshFilePath )
     preciceIsInitialized_ = true;
 }
 
-void InpreciceAdapter::runCouplingThreaded()
+void InpreciceAdapter::produce()
 {
     assert( preciceIsInitialized_ );
-    preciceThread_ = std::thread(
-            &InpreciceAdapter::runCoupling,
-            this,
-            std::ref(visInfoData_));
-}
-
-void InpreciceAdapter::runCoupling(
-    VisualizationDataInfoVec_t& visInfoDataVec_)
-{
     while(interface_->isCouplingOngoing())
     {
-        for (auto& visInfo: visInfoDataVec_ )
+        VisualizationDataInfoVec_t& backData = accessBackSnapshot().data;
+        for (size_t m = 0; m < visInfoData_.size(); ++m)
         {
-            for (size_t i = 0; i < visInfo.buffers.size(); ++i)
+            const auto& visInfo = visInfoData_[m];
+            for (size_t i = 0; i < visInfo.dataIDs.size(); ++i)
             {
-                std::lock_guard<std::mutex> guard( dataMutex_ );
-                interface_->readBlockScalarData(
-                    visInfo.dataIDs[i],
-                    static_cast<int>(visInfo.vertexIDs.size()),
-                    visInfo.vertexIDs.data(),
-                    visInfo.buffers[i].data());
+                {
+                    TRACE_SCOPE("readBlockScalarData");
+                    interface_->readBlockScalarData(
+                        visInfo.dataIDs[i],
+                        static_cast<int>(visInfo.vertexIDs.size()),
+                        visInfo.vertexIDs.data(),
+                        readBuffer_.data());
+                }
+
+                // convert once per coupling step instead of once per frame
+                TRACE_SCOPE("convertToFloat");
+                convertToFloat(
+                    readBuffer_.data(),
+                    visInfo.vertexIDs.size(),
+                    backData[m].buffers[i].data());
             }
         }
+        publish();
 
+        TRACE_SCOPE("advance");
         const double preciceDt = interface_->advance(timeStepSize_);
         timeStepSize_ = std::max( timeStepSize_, preciceDt );
     }
 }
 
-const VisualizationDataInfoVec_t& InpreciceAdapter::getVisualisationData()
+void InpreciceAdapter::finalizeSource()
 {
-  std::lock_guard<std::mutex> guard( dataMutex_ );
-  return visInfoData_;
-}
-
-void InpreciceAdapter::finalize()
-{
-  preciceThread_.join();
-  interface_->finalize();
+  // nothing to finalize for an unsupported benchmark case
+  if (preciceIsInitialized_)
+    interface_->finalize();
 }
 
 InpreciceAdapter::~InpreciceAdapter()
 {
 
 }
-
-
@@ -1,33 +1,25 @@
 #pragma once
 
 #include <array>
-#include <mutex>
-#include <ostream>
+#include <memory>
 #include <string>
-#include <thread>
-#include <boost/multi_array.hpp>
+#include <vector>
 
 #include <precice/SolverInterface.hpp>
 
-namespace inpreciceadapter {
-
-struct VisualizationDataInfo
-{
-    int meshID{-1};
-    std::vector<int> dataIDs{};
-    std::vector<std::string> dataNames{};
-    std::string meshName{""};
-
-    std::array< size_t, 2 > gridDimension{};
-    std::vector<int> vertexIDs{};
-    std::vector<boost::multi_array<double, 2> > buffers{};
-};
+#include "datasource.hpp"
 
-std::ostream& operator<<(std::ostream& os, const VisualizationDataInfo& info);
-
-using VisualizationDataInfoVec_t = std::vector<VisualizationDataInfo>;
+namespace inpreciceadapter {
 
-class InpreciceAdapter
+/**
+ * \brief Couples the visualization to a solver via preCICE
+ *
+ * The coupling runs on the producer thread and never blocks on the renderer:
+ * data is read from preCICE into the private back snapshot without any lock
+ * held and then published with a single atomic pointer store. The coupling
+ * can not be stopped early, finalize() waits until it has ended.
+ */
+class InpreciceAdapter : public DataSource
 {
     // Alias for grid dimension
     using gridDimension_t = std::array< size_t, 2 >;
@@ -35,14 +27,13 @@ class InpreciceAdapter
     private:
     // Unique pointer to preCICe instance
     std::unique_ptr<precice::SolverInterface> interface_;
-    // Mutex for data access when threaded execution is run
-    std::mutex dataMutex_;
 
     // Number of the fracture benchmark case
     int bmCase_;
 
-    // True if the visualization mesh has been created
-    bool meshIsCreated_;
+    // File with the visualization meshes
+    std::string meshFilePath_;
+
     // True if initialize() routine of preCICE has been called
     bool preciceIsInitialized_;
 
@@ -50,9 +41,14 @@ class InpreciceAdapter
 
     VisualizationDataInfoVec_t visInfoData_;
 
-    std::thread preciceThread_;
+    // Double precision staging buffer for reading data from preCICE
+    // (coupling thread only)
+    std::vector<double> readBuffer_;
 
-    void runCoupling(VisualizationDataInfoVec_t& visInfoDataVec_);
+    protected:
+    void initializeSource(VisualizationDataInfoVec_t& layout) override;
+    void produce() override;
+    void finalizeSource() override;
 
     public:
     // No standard constructor as we want to create preCICE instance on creation of adapter
@@ -66,21 +62,16 @@ class InpreciceAdapter
                      const size_t solverProcessRank,
                      const size_t solverNumberOfProcesses );
 
-
-
-    void setMeshName( const std::string& meshName );
+    /**
+     * \brief Sets the json or binary file with the visualization meshes,
+     *        has to be called before initialize()
+     */
     void setVisualizationMesh( const std::string& meshFilePath );
 
+    using DataSource::initialize;
     void initialize(const std::string& meshFilePath);
 
-    void runCouplingThreaded();
-
-    const VisualizationDataInfoVec_t& getVisualisationData();
-
-    void finalize();
-
     virtual ~InpreciceAdapter();
 };
 
 } //namespace inpreciceadapter
-
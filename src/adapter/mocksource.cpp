@@ -0,0 +1,202 @@
+#include "mocksource.hpp"
+#include "trace/trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace inpreciceadapter;
+
+namespace {
+
+// minimum number of grid points for generating a field multithreaded
+constexpr size_t PARALLEL_FIELD_MIN_POINTS = 256 * 256;
+
+// Simulated time advanced per time step
+constexpr double TIME_PER_STEP = 0.02;
+
+// The front moves with FRONT_SPEED along its direction and reappears at the
+// start after crossing the grid. It is 0.5 * (1 - tanh(d / FRONT_WIDTH)) of
+// the signed distance d to the front, which equals 1 / (1 + exp(2d / w)) and
+// makes it separable into a row and a column factor. The width bounds the
+// product of the factors to exp(+-68), so it stays a normal float.
+constexpr double FRONT_SPEED = 0.15;
+constexpr double FRONT_WIDTH = 0.05;
+
+// Plumes circle around the center of the grid with pulsating width
+constexpr size_t NUM_PLUMES = 2;
+constexpr double PLUME_RADIUS = 0.3;
+constexpr double PLUME_ANGULAR_SPEED = 0.8;
+constexpr double PLUME_SIGMA = 0.06;
+constexpr double PLUME_SIGMA_VARIATION = 0.03;
+constexpr double PLUME_AMPLITUDE = 0.9;
+
+constexpr size_t NUM_TERMS = 1 + NUM_PLUMES;
+
+// golden angle, spreads the directions and phases of the fractures evenly
+constexpr double FRACTURE_ANGLE = 2.399963229728653;
+
+/**
+ * \brief Normalized position of a grid index in [0,1]
+ */
+double gridCoordinate(size_t index, size_t size)
+{
+    return (size > 1) ? index / static_cast<double>(size - 1) : 0.5;
+}
+
+} // namespace
+
+MockSource::MockSource(
+    size_t numFractures,
+    const std::array<size_t, 2>& gridDimension,
+    double stepsPerSecond,
+    uint64_t numSteps ) :
+        numFractures_(numFractures),
+        gridDimension_(gridDimension),
+        stepsPerSecond_(stepsPerSecond),
+        numSteps_(numSteps)
+{
+}
+
+MockSource::~MockSource()
+{
+    stop();
+}
+
+void MockSource::initializeSource(VisualizationDataInfoVec_t& layout)
+{
+    if ((0 == numFractures_) ||
+            (0 == gridDimension_[0]) || (0 == gridDimension_[1]))
+        throw std::runtime_error("Mock data source has no grid points");
+
+    // names as in the vis-mesh files of the benchmark cases
+    layout.resize(numFractures_);
+    for (size_t f = 0; f < numFractures_; ++f)
+    {
+        const std::string suffix =
+            (1 == numFractures_) ? "" : std::to_string(f);
+
+        VisualizationDataInfo &visInfo = layout[f];
+        visInfo.meshName = "VisualizationMesh" + suffix;
+        visInfo.dataNames = { "Concentration" + suffix };
+        visInfo.gridDimension = gridDimension_;
+    }
+
+    rowFactors_.resize(NUM_TERMS * gridDimension_[0]);
+    columnFactors_.resize(NUM_TERMS * gridDimension_[1]);
+
+    std::cout << "Generating " << numFractures_ << " synthetic fields with "
+        << gridDimension_[0] << " x " << gridDimension_[1] << " points"
+        << std::endl;
+}
+
+void MockSource::produce()
+{
+    using clock_t = std::chrono::steady_clock;
+    const auto interval =
+        std::chrono::duration_cast<clock_t::duration>(
+            std::chrono::duration<double>(
+                (stepsPerSecond_ > 0.) ? 1. / stepsPerSecond_ : 0.));
+
+    clock_t::time_point next = clock_t::now();
+    for (uint64_t step = 0; (0 == numSteps_) || (step < numSteps_); ++step)
+    {
+        VisualizationDataInfoVec_t& backData = accessBackSnapshot().data;
+        for (size_t f = 0; f < numFractures_; ++f)
+            generateField(f, step, backData[f].buffers[0]);
+
+        next += interval;
+        if (!waitUntil(next))
+            break;
+
+        publish();
+    }
+}
+
+void MockSource::generateField(
+        size_t fracture,
+        uint64_t step,
+        boost::multi_array<float, 2>& field)
+{
+    TRACE_SCOPE("MockSource::generateField");
+    const size_t ny = gridDimension_[0];
+    const size_t nx = gridDimension_[1];
+    const double t = step * TIME_PER_STEP;
+    const double angle = fracture * FRACTURE_ANGLE;
+
+    float* const frontRow = rowFactors_.data();
+    float* const frontColumn = columnFactors_.data();
+
+    // signed distance to the front, the front position runs from -0.2 to 1.2
+    // along the direction when projected to [0,1]
+    const double dx = std::cos(angle);
+    const double dy = std::sin(angle);
+    const double position =
+        std::fmod(FRONT_SPEED * t + 0.1 * fracture, 1.4) - 0.2;
+    const double scale = 2. / FRONT_WIDTH;
+    for (size_t iy = 0; iy < ny; ++iy)
+        frontRow[iy] = static_cast<float>(std::exp(scale * (
+            dy * (gridCoordinate(iy, ny) - 0.5) + 0.5 - position)));
+    for (size_t ix = 0; ix < nx; ++ix)
+        frontColumn[ix] = static_cast<float>(std::exp(scale *
+            dx * (gridCoordinate(ix, nx) - 0.5)));
+
+    for (size_t k = 0; k < NUM_PLUMES; ++k)
+    {
+        float* const plumeRow = rowFactors_.data() + (1 + k) * ny;
+        float* const plumeColumn = columnFactors_.data() + (1 + k) * nx;
+
+        const double phase = angle + k * M_PI;
+        const double cx = 0.5 + PLUME_RADIUS *
+            std::cos(PLUME_ANGULAR_SPEED * t + phase);
+        const double cy = 0.5 + PLUME_RADIUS *
+            std::sin(PLUME_ANGULAR_SPEED * t + phase);
+        const double sigma = PLUME_SIGMA +
+            PLUME_SIGMA_VARIATION * std::sin(2. * t + phase);
+        const double c = -0.5 / (sigma * sigma);
+
+        for (size_t iy = 0; iy < ny; ++iy)
+        {
+            const double y = gridCoordinate(iy, ny) - cy;
+            plumeRow[iy] =
+                static_cast<float>(PLUME_AMPLITUDE * std::exp(c * y * y));
+        }
+        for (size_t ix = 0; ix < nx; ++ix)
+        {
+            const double x = gridCoordinate(ix, nx) - cx;
+            plumeColumn[ix] = static_cast<float>(std::exp(c * x * x));
+        }
+    }
+
+    float* const data = field.data();
+    const float* const rows = rowFactors_.data();
+    const float* const columns = columnFactors_.data();
+
+    // the row stays in cache while the terms are added one after another
+    #pragma omp parallel for if(nx * ny >= PARALLEL_FIELD_MIN_POINTS)
+    for (size_t iy = 0; iy < ny; ++iy)
+    {
+        float* const row = data + iy * nx;
+
+        const float frontFactor = rows[iy];
+        #pragma omp simd
+        for (size_t ix = 0; ix < nx; ++ix)
+            row[ix] = 1.f / (1.f + frontFactor * columns[ix]);
+
+        for (size_t k = 1; k < NUM_TERMS; ++k)
+        {
+            const float plumeFactor = rows[k * ny + iy];
+            const float* const plumeColumn = columns + k * nx;
+            #pragma omp simd
+            for (size_t ix = 0; ix < nx; ++ix)
+                row[ix] += plumeFactor * plumeColumn[ix];
+        }
+
+        #pragma omp simd
+        for (size_t ix = 0; ix < nx; ++ix)
+            row[ix] = std::min(row[ix], 1.f);
+    }
+}
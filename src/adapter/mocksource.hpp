@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "datasource.hpp"
+
+namespace inpreciceadapter {
+
+/**
+ * \brief Generates synthetic, time dependent concentration fields
+ *
+ * Each fracture shows a front moving across the grid and Gaussian plumes
+ * circling around its center, with direction and phases varying between the
+ * fractures. The fields are analytic, so arbitrary grid sizes and numbers of
+ * fractures can be produced without preCICE or a solver, e.g. for load
+ * testing the renderer.
+ */
+class MockSource : public DataSource
+{
+    public:
+    /**
+     * \param numFractures    number of meshes, one concentration field each
+     * \param gridDimension   grid dimension of every mesh
+     * \param stepsPerSecond  rate of generated time steps, 0 for as fast as
+     *                        possible
+     * \param numSteps        number of time steps to generate, 0 for running
+     *                        until finalize() is called
+     */
+    MockSource(
+            size_t numFractures,
+            const std::array<size_t, 2>& gridDimension,
+            double stepsPerSecond,
+            uint64_t numSteps = 0);
+    ~MockSource() override;
+
+    protected:
+    void initializeSource(VisualizationDataInfoVec_t& layout) override;
+    void produce() override;
+
+    private:
+    size_t numFractures_;
+    std::array<size_t, 2> gridDimension_;
+    double stepsPerSecond_;
+    uint64_t numSteps_;
+
+    // separable factors of the fields along the rows and columns of the grid
+    // (producer thread only)
+    std::vector<float> rowFactors_;
+    std::vector<float> columnFactors_;
+
+    void generateField(
+            size_t fracture,
+            uint64_t step,
+            boost::multi_array<float, 2>& field);
+};
+
+} //namespace inpreciceadapter
@@ -0,0 +1,427 @@
+#include "recording.hpp"
+#include "binaryio.hpp"
+#include "trace/trace.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include <zlib.h>
+
+using namespace inpreciceadapter;
+using binaryio::readValue;
+using binaryio::writeValue;
+
+constexpr size_t Recorder::QUEUE_CAPACITY;
+constexpr size_t RecordingReader::NO_STEP;
+
+namespace {
+
+// size of the header in front of each compressed time step in bytes
+constexpr size_t STEP_HEADER_SIZE = 32;
+
+/**
+ * \brief XOR encodes the float bits of a field and splits them into byte
+ *        planes
+ *
+ * \param values    field values
+ * \param n         number of values
+ * \param keyframe  encode relative to the previous value instead of the
+ *                  previous time step
+ * \param previous  bits of the previous time step, updated to the bits of
+ *                  the values
+ * \param out       output for 4 * n bytes
+ */
+void encodeField(
+        const float* values,
+        size_t n,
+        bool keyframe,
+        uint32_t* previous,
+        uint8_t* out)
+{
+    uint32_t last = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &values[i], sizeof(bits));
+
+        const uint32_t delta = bits ^ (keyframe ? last : previous[i]);
+        last = bits;
+        previous[i] = bits;
+
+        out[i] = static_cast<uint8_t>(delta);
+        out[n + i] = static_cast<uint8_t>(delta >> 8);
+        out[2 * n + i] = static_cast<uint8_t>(delta >> 16);
+        out[3 * n + i] = static_cast<uint8_t>(delta >> 24);
+    }
+}
+
+/**
+ * \brief Inverse of encodeField, the decoded bits are written to previous
+ */
+void decodeField(
+        const uint8_t* in,
+        size_t n,
+        bool keyframe,
+        uint32_t* previous)
+{
+    uint32_t last = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const uint32_t delta =
+            static_cast<uint32_t>(in[i]) |
+            (static_cast<uint32_t>(in[n + i]) << 8) |
+            (static_cast<uint32_t>(in[2 * n + i]) << 16) |
+            (static_cast<uint32_t>(in[3 * n + i]) << 24);
+
+        const uint32_t bits = delta ^ (keyframe ? last : previous[i]);
+        last = bits;
+        previous[i] = bits;
+    }
+}
+
+void writeString(std::ostream& os, const std::string& str)
+{
+    writeValue(os, static_cast<uint32_t>(str.size()));
+    os.write(str.data(), str.size());
+}
+
+std::string readString(const char* data, size_t size, size_t& offset)
+{
+    const uint32_t length = readValue<uint32_t>(data, size, offset);
+    offset += sizeof(length);
+    if ((offset > size) || (length > size - offset))
+        throw std::runtime_error("Recording file is truncated");
+
+    std::string str(data + offset, length);
+    offset += length;
+    return str;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+// Recorder
+//-----------------------------------------------------------------------------
+Recorder::Recorder(
+    const std::string& path,
+    const VisualizationDataInfoVec_t& layout ) :
+        file_(path.c_str(), std::ofstream::out | std::ofstream::binary),
+        queue_(QUEUE_CAPACITY),
+        queueHead_(0),
+        queueSize_(0),
+        stop_(false),
+        failed_(false),
+        droppedSnapshots_(0),
+        numWrittenSteps_(0)
+{
+    if (!file_.good())
+        throw std::runtime_error("Could not create recording file " + path);
+
+    file_.write(recording::MAGIC, sizeof(recording::MAGIC));
+    writeValue(file_, recording::VERSION);
+    writeValue(file_, static_cast<uint32_t>(layout.size()));
+
+    // all encoder buffers are allocated up front
+    size_t rawSize = 0;
+    for (const auto& visInfo : layout)
+    {
+        writeValue(file_, static_cast<uint64_t>(visInfo.gridDimension[0]));
+        writeValue(file_, static_cast<uint64_t>(visInfo.gridDimension[1]));
+        writeValue(file_, static_cast<uint32_t>(visInfo.dataNames.size()));
+        writeString(file_, visInfo.meshName);
+
+        const size_t numValues =
+            visInfo.gridDimension[0] * visInfo.gridDimension[1];
+        for (const auto& dataName : visInfo.dataNames)
+        {
+            writeString(file_, dataName);
+            previousBits_.emplace_back(numValues, 0);
+            rawSize += sizeof(uint32_t) * numValues;
+        }
+    }
+    file_.flush();
+    if (!file_.good())
+        throw std::runtime_error("Could not write recording file " + path);
+
+    rawBuffer_.resize(rawSize);
+    compressedBuffer_.resize(compressBound(rawSize));
+
+    writerThread_ = std::thread(&Recorder::runWriter, this);
+}
+
+Recorder::~Recorder()
+{
+    close();
+}
+
+bool Recorder::push(VisualizationSnapshotPtr_t snapshot)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        if (failed_)
+            return false;
+        if (stop_ || (queueSize_ == queue_.size()))
+        {
+            ++droppedSnapshots_;
+            return false;
+        }
+        queue_[(queueHead_ + queueSize_) % queue_.size()] =
+            std::move(snapshot);
+        ++queueSize_;
+    }
+    queueCondition_.notify_one();
+
+    return true;
+}
+
+void Recorder::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        stop_ = true;
+    }
+    queueCondition_.notify_one();
+
+    if (writerThread_.joinable())
+        writerThread_.join();
+    if (file_.is_open())
+        file_.close();
+}
+
+void Recorder::runWriter()
+{
+    TRACE_THREAD_NAME("recorder");
+    while (true)
+    {
+        VisualizationSnapshotPtr_t snapshot;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            queueCondition_.wait(
+                lock, [this](){ return stop_ || (queueSize_ > 0); });
+            if (0 == queueSize_)
+                return;
+
+            snapshot = std::move(queue_[queueHead_]);
+            queueHead_ = (queueHead_ + 1) % queue_.size();
+            --queueSize_;
+        }
+
+        // the snapshot is released afterwards and can be reused for
+        // publishing
+        if (!writeSnapshot(*snapshot))
+            break;
+    }
+
+    // release the queued snapshots, the recording ends with the last
+    // complete time step
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    failed_ = true;
+    for (; queueSize_ > 0; --queueSize_)
+    {
+        queue_[queueHead_].reset();
+        queueHead_ = (queueHead_ + 1) % queue_.size();
+    }
+}
+
+/**
+ * \brief Encodes, compresses and writes a time step
+ *
+ * \return false if the file could not be written
+ */
+bool Recorder::writeSnapshot(const VisualizationSnapshot& snapshot)
+{
+    TRACE_SCOPE("Recorder::writeSnapshot");
+    const bool keyframe =
+        (0 == numWrittenSteps_ % recording::KEYFRAME_INTERVAL);
+
+    size_t offset = 0;
+    size_t field = 0;
+    for (const auto& visInfo : snapshot.data)
+    {
+        for (const auto& buffer : visInfo.buffers)
+        {
+            const size_t n = buffer.num_elements();
+            encodeField(
+                buffer.data(),
+                n,
+                keyframe,
+                previousBits_[field].data(),
+                rawBuffer_.data() + offset);
+            offset += sizeof(uint32_t) * n;
+            ++field;
+        }
+    }
+
+    uLongf compressedSize = compressedBuffer_.size();
+    if (Z_OK != compress2(
+            compressedBuffer_.data(),
+            &compressedSize,
+            rawBuffer_.data(),
+            offset,
+            Z_BEST_SPEED))
+    {
+        std::cerr << "Error: compression of time step " << snapshot.version
+            << " failed!" << std::endl;
+        // the following steps must not refer to the missing one
+        numWrittenSteps_ = 0;
+        return true;
+    }
+
+    writeValue(file_, static_cast<uint64_t>(snapshot.version));
+    writeValue(file_, keyframe ? recording::FLAG_KEYFRAME : uint32_t(0));
+    writeValue(file_, uint32_t(0));
+    writeValue(file_, static_cast<uint64_t>(offset));
+    writeValue(file_, static_cast<uint64_t>(compressedSize));
+    file_.write(
+        reinterpret_cast<const char*>(compressedBuffer_.data()),
+        compressedSize);
+    if (!file_.good())
+    {
+        std::cerr << "Error: writing time step " << snapshot.version
+            << " to the recording failed, recording stopped!" << std::endl;
+        return false;
+    }
+
+    ++numWrittenSteps_;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// RecordingReader
+//-----------------------------------------------------------------------------
+void RecordingReader::open(const std::string& path)
+{
+    layout_.clear();
+    steps_.clear();
+    previousBits_.clear();
+    decodedStep_ = NO_STEP;
+    if (mappedFile_.is_open())
+        mappedFile_.close();
+
+    mappedFile_.open(path);
+    const char* data = mappedFile_.data();
+    const size_t size = mappedFile_.size();
+
+    if ((size < sizeof(recording::MAGIC)) || (0 != std::memcmp(
+            data, recording::MAGIC, sizeof(recording::MAGIC))))
+        throw std::runtime_error(path + " is no recording file");
+    if (recording::VERSION != readValue<uint32_t>(data, size, 8))
+        throw std::runtime_error("Unsupported recording file version");
+    const uint32_t numMeshes = readValue<uint32_t>(data, size, 12);
+
+    size_t offset = 16;
+    size_t rawSize = 0;
+    layout_.resize(numMeshes);
+    for (auto& visInfo : layout_)
+    {
+        visInfo.gridDimension[0] = readValue<uint64_t>(data, size, offset);
+        visInfo.gridDimension[1] = readValue<uint64_t>(data, size, offset + 8);
+        const uint32_t numFields = readValue<uint32_t>(data, size, offset + 16);
+        offset += 20;
+        visInfo.meshName = readString(data, size, offset);
+
+        const size_t numValues =
+            visInfo.gridDimension[0] * visInfo.gridDimension[1];
+        for (uint32_t i = 0; i < numFields; ++i)
+        {
+            visInfo.dataNames.push_back(readString(data, size, offset));
+            previousBits_.emplace_back(numValues, 0);
+            rawSize += sizeof(uint32_t) * numValues;
+        }
+    }
+    rawBuffer_.resize(rawSize);
+
+    // index the time steps, a truncated last step is ignored
+    while (size - offset >= STEP_HEADER_SIZE)
+    {
+        StepInfo step;
+        step.version = readValue<uint64_t>(data, size, offset);
+        step.keyframe = (0 != (recording::FLAG_KEYFRAME &
+            readValue<uint32_t>(data, size, offset + 8)));
+        step.rawSize = readValue<uint64_t>(data, size, offset + 16);
+        step.compressedSize = readValue<uint64_t>(data, size, offset + 24);
+        step.payloadOffset = offset + STEP_HEADER_SIZE;
+
+        if (step.compressedSize > size - step.payloadOffset)
+            break;
+        if (step.rawSize != rawSize)
+            throw std::runtime_error("Recording file contains invalid step");
+        if (steps_.empty() && !step.keyframe)
+            throw std::runtime_error("Recording file lacks first key frame");
+
+        steps_.push_back(step);
+        offset = step.payloadOffset + step.compressedSize;
+    }
+}
+
+void RecordingReader::read(size_t step, VisualizationSnapshot& snapshot)
+{
+    if (step >= steps_.size())
+        throw std::runtime_error("Time step is not in the recording");
+
+    // continue from the last decoded step if no key frame is closer
+    size_t keyframe = step;
+    while (!steps_[keyframe].keyframe)
+        --keyframe;
+
+    size_t first = keyframe;
+    if ((NO_STEP != decodedStep_) && (decodedStep_ <= step) &&
+            (decodedStep_ >= keyframe))
+        first = decodedStep_ + 1;
+
+    for (size_t i = first; i <= step; ++i)
+        decodeStep(i);
+
+    if (snapshot.data.size() != layout_.size())
+        snapshot.data = allocateSnapshotData(layout_);
+
+    size_t field = 0;
+    for (auto& visInfo : snapshot.data)
+    {
+        for (auto& buffer : visInfo.buffers)
+        {
+            const std::vector<uint32_t>& bits = previousBits_[field++];
+            if (buffer.num_elements() != bits.size())
+                throw std::runtime_error(
+                    "Snapshot does not match the recording layout");
+            std::memcpy(
+                buffer.data(), bits.data(), sizeof(uint32_t) * bits.size());
+        }
+    }
+    snapshot.version = steps_[step].version;
+}
+
+void RecordingReader::decodeStep(size_t step)
+{
+    const StepInfo& info = steps_[step];
+
+    uLongf rawSize = rawBuffer_.size();
+    const int ret = uncompress(
+        rawBuffer_.data(),
+        &rawSize,
+        reinterpret_cast<const Bytef*>(
+            mappedFile_.data() + info.payloadOffset),
+        info.compressedSize);
+    if ((Z_OK != ret) || (rawSize != info.rawSize))
+    {
+        decodedStep_ = NO_STEP;
+        throw std::runtime_error(
+            "Time step " + std::to_string(info.version) +
+            " of the recording is corrupted");
+    }
+
+    size_t offset = 0;
+    for (auto& bits : previousBits_)
+    {
+        decodeField(
+            rawBuffer_.data() + offset,
+            bits.size(),
+            info.keyframe,
+            bits.data());
+        offset += sizeof(uint32_t) * bits.size();
+    }
+
+    decodedStep_ = step;
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include "snapshot.hpp"
+
+namespace inpreciceadapter {
+
+/**
+ * \brief Layout of recording files
+ *
+ * All values are little endian, strings are stored as uint32 length followed
+ * by the characters.
+ *
+ *   header:  char magic[8] = "IPCVREC1", uint32 version, uint32 numMeshes
+ *   meshes:  numMeshes entries of
+ *              uint64 gridDimension[2], uint32 numFields,
+ *              string meshName, numFields x string dataName
+ *   steps:   one chunk per recorded time step
+ *              uint64 version, uint32 flags, uint32 reserved,
+ *              uint64 rawSize, uint64 compressedSize,
+ *              zlib compressed payload
+ *
+ * The payload holds all fields of all meshes in order. The float bits of a
+ * field are XORed with the previous time step (or with the previous value
+ * of the field for key frames) and split into four byte planes, starting
+ * with the least significant byte, which makes smooth, slowly changing data
+ * compress well.
+ */
+namespace recording {
+    constexpr char MAGIC[8] = { 'I', 'P', 'C', 'V', 'R', 'E', 'C', '1' };
+    constexpr uint32_t VERSION = 1;
+    constexpr uint32_t FLAG_KEYFRAME = 1;
+    // number of time steps between two key frames
+    constexpr uint64_t KEYFRAME_INTERVAL = 32;
+}
+
+/**
+ * \brief Writes published snapshots to a recording file on its own thread
+ *
+ * Snapshots are passed by pointer through a bounded queue, so pushing never
+ * copies data or waits for the disk. If the writer falls behind, new
+ * snapshots are dropped instead of stalling the coupling. If writing to the
+ * file fails, e.g. because the disk is full, the recording stops and later
+ * snapshots are discarded.
+ */
+class Recorder
+{
+    public:
+    static constexpr size_t QUEUE_CAPACITY = 8;
+
+    /**
+     * \brief Creates the recording file and starts the writer thread
+     *
+     * Throws std::runtime_error if the file can not be created or the
+     * header can not be written.
+     */
+    Recorder(const std::string& path, const VisualizationDataInfoVec_t& layout);
+    Recorder( const Recorder& ) = delete;
+    Recorder& operator=( const Recorder& ) = delete;
+    ~Recorder();
+
+    /**
+     * \brief Queues a snapshot for writing without blocking
+     *
+     * \return false if the queue was full or the recording has failed
+     *         and the snapshot was dropped
+     */
+    bool push(VisualizationSnapshotPtr_t snapshot);
+
+    /**
+     * \brief Writes all queued snapshots and closes the file
+     */
+    void close();
+
+    size_t getNumDroppedSnapshots() const { return droppedSnapshots_; }
+
+    private:
+    std::ofstream file_;
+
+    // ring of queued snapshots
+    std::vector<VisualizationSnapshotPtr_t> queue_;
+    size_t queueHead_;
+    size_t queueSize_;
+    bool stop_;
+    bool failed_;
+    std::mutex queueMutex_;
+    std::condition_variable queueCondition_;
+    std::atomic<size_t> droppedSnapshots_;
+
+    std::thread writerThread_;
+
+    // encoder state, only used by the writer thread
+    uint64_t numWrittenSteps_;
+    std::vector< std::vector<uint32_t> > previousBits_;
+    std::vector<uint8_t> rawBuffer_;
+    std::vector<uint8_t> compressedBuffer_;
+
+    void runWriter();
+    bool writeSnapshot(const VisualizationSnapshot& snapshot);
+};
+
+/**
+ * \brief Reads the time steps of a recording file
+ *
+ * The file is memory mapped. Time steps are decoded fastest in increasing
+ * order, random access decodes from the preceding key frame.
+ */
+class RecordingReader
+{
+    public:
+    RecordingReader() = default;
+    RecordingReader( const RecordingReader& ) = delete;
+    RecordingReader& operator=( const RecordingReader& ) = delete;
+
+    /**
+     * \brief Opens a recording file and indexes its time steps
+     *
+     * Throws std::runtime_error if the file can not be read or is malformed.
+     */
+    void open(const std::string& path);
+
+    /**
+     * \brief Meshes and data names of the recording
+     */
+    const VisualizationDataInfoVec_t& getLayout() const { return layout_; }
+
+    size_t getNumSteps() const { return steps_.size(); }
+
+    /**
+     * \brief Decodes a time step into a snapshot with the layout of the
+     *        recording
+     *
+     * Throws std::runtime_error if the time step is corrupted.
+     */
+    void read(size_t step, VisualizationSnapshot& snapshot);
+
+    private:
+    struct StepInfo
+    {
+        uint64_t version{0};
+        bool keyframe{false};
+        size_t payloadOffset{0};
+        size_t rawSize{0};
+        size_t compressedSize{0};
+    };
+
+    boost::iostreams::mapped_file_source mappedFile_;
+    VisualizationDataInfoVec_t layout_{};
+    std::vector<StepInfo> steps_{};
+
+    // decoder state
+    static constexpr size_t NO_STEP = static_cast<size_t>(-1);
+    size_t decodedStep_{NO_STEP};
+    std::vector< std::vector<uint32_t> > previousBits_{};
+    std::vector<uint8_t> rawBuffer_{};
+
+    void decodeStep(size_t step);
+};
+
+} //namespace inpreciceadapter
@@ -0,0 +1,54 @@
+#include "replaysource.hpp"
+#include "trace/trace.hpp"
+
+#include <chrono>
+#include <iostream>
+
+using namespace inpreciceadapter;
+
+ReplaySource::ReplaySource(
+    const std::string& recordingPath,
+    double stepsPerSecond ) :
+        recordingPath_(recordingPath),
+        stepsPerSecond_(stepsPerSecond)
+{
+}
+
+ReplaySource::~ReplaySource()
+{
+    stop();
+}
+
+void ReplaySource::initializeSource(VisualizationDataInfoVec_t& layout)
+{
+    reader_.open(recordingPath_);
+    layout = reader_.getLayout();
+
+    std::cout << "Replaying " << reader_.getNumSteps() << " time steps from "
+        << recordingPath_ << std::endl;
+}
+
+void ReplaySource::produce()
+{
+    using clock_t = std::chrono::steady_clock;
+    const auto interval =
+        std::chrono::duration_cast<clock_t::duration>(
+            std::chrono::duration<double>(
+                (stepsPerSecond_ > 0.) ? 1. / stepsPerSecond_ : 0.));
+
+    clock_t::time_point next = clock_t::now();
+    for (size_t step = 0; step < reader_.getNumSteps(); ++step)
+    {
+        {
+            TRACE_SCOPE("RecordingReader::read");
+            reader_.read(step, accessBackSnapshot());
+        }
+
+        // the next step is decoded while waiting for its publish time
+        next += interval;
+        if (!waitUntil(next))
+            break;
+
+        publish();
+    }
+}
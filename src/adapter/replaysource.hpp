@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+
+#include "datasource.hpp"
+#include "recording.hpp"
+
+namespace inpreciceadapter {
+
+/**
+ * \brief Plays back a recording written by the Recorder
+ *
+ * Provides the same snapshots as the InpreciceAdapter did during the
+ * recorded run, but needs neither preCICE nor a coupled solver. Time steps
+ * are decoded from the memory mapped recording on the producer thread and
+ * published at a fixed rate or as fast as possible.
+ */
+class ReplaySource : public DataSource
+{
+    public:
+    /**
+     * \param recordingPath   recording file to play back
+     * \param stepsPerSecond  playback rate, 0 for as fast as possible
+     */
+    ReplaySource(const std::string& recordingPath, double stepsPerSecond);
+    ~ReplaySource() override;
+
+    protected:
+    /**
+     * \brief Opens the recording
+     *
+     * Throws std::runtime_error if the recording can not be read.
+     */
+    void initializeSource(VisualizationDataInfoVec_t& layout) override;
+    void produce() override;
+
+    private:
+    std::string recordingPath_;
+    double stepsPerSecond_;
+
+    // only used by the producer thread after initialization
+    RecordingReader reader_;
+};
+
+} //namespace inpreciceadapter
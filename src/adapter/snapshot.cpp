@@ -0,0 +1,204 @@
+#include "snapshot.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <utility>
+
+std::ostream& inpreciceadapter::operator<<(
+        std::ostream& os,
+        const VisualizationDataInfo& info )
+{
+    os << "  Mesh id: "   << info.meshID << "\n"
+        << "  Mesh name: "  << info.meshName << "\n"
+        << "  Mesh dim: " << info.gridDimension[0] << " x "
+            << info.gridDimension[1] << "\n"
+        << "  #Vertices: " << info.vertexIDs.size() << "\n"
+        << std::endl;
+
+    os << "Data names:" << std::endl;
+
+    assert(info.dataIDs.size() == info.dataNames.size());
+    for (size_t i = 0; i < info.dataIDs.size(); ++i)
+        os << info.dataNames[i] << "(ID: " << info.dataIDs[i] << ")" << "\n";
+
+    os << std::endl;
+
+    return os;
+}
+
+using namespace inpreciceadapter;
+
+VisualizationDataInfoVec_t inpreciceadapter::allocateSnapshotData(
+        const VisualizationDataInfoVec_t& layout)
+{
+    VisualizationDataInfoVec_t data;
+    data.reserve(layout.size());
+    for (const auto& visInfo : layout)
+    {
+        data.emplace_back();
+        VisualizationDataInfo& snapshotInfo = data.back();
+        snapshotInfo.meshID = visInfo.meshID;
+        snapshotInfo.dataIDs = visInfo.dataIDs;
+        snapshotInfo.dataNames = visInfo.dataNames;
+        snapshotInfo.meshName = visInfo.meshName;
+        snapshotInfo.gridDimension = visInfo.gridDimension;
+
+        const auto& gridDimension = visInfo.gridDimension;
+        for (size_t i = 0; i < visInfo.dataNames.size(); ++i)
+            snapshotInfo.buffers.emplace_back(
+                boost::extents[gridDimension[0]][gridDimension[1]]);
+    }
+
+    return data;
+}
+
+SnapshotPublisher::SnapshotPublisher() :
+    layout_(),
+    publishedVersion_(0),
+    historyLength_(0),
+    finished_(false)
+{
+}
+
+void SnapshotPublisher::setHistoryLength(size_t length)
+{
+    assert( snapshotPool_.empty() );
+    historyLength_ = length;
+}
+
+void SnapshotPublisher::initialize(
+        const VisualizationDataInfoVec_t& layout, size_t numHeldOutside)
+{
+    layout_ = layout;
+
+    // the back buffer is filled by the producer, the front buffer is what
+    // the readers see until the first snapshot is published
+    snapshotPool_.clear();
+    for (size_t i = 0;
+            i < SNAPSHOT_POOL_SIZE + historyLength_ + numHeldOutside;
+            ++i)
+    {
+        snapshotPool_.push_back(std::make_shared<VisualizationSnapshot>());
+        snapshotPool_.back()->data = allocateSnapshotData(layout_);
+    }
+    std::atomic_store(&frontSnapshot_, snapshotPool_[0]);
+    backSnapshot_ = snapshotPool_[1];
+    history_.assign(historyLength_, nullptr);
+}
+
+VisualizationSnapshotPtr_t SnapshotPublisher::publish()
+{
+    backSnapshot_->version = ++publishedVersion_;
+
+    std::atomic_store(&frontSnapshot_, backSnapshot_);
+    // this releases the oldest snapshot of the history for reuse
+    if (historyLength_ > 0)
+        std::atomic_store(
+            &history_[publishedVersion_ % historyLength_], backSnapshot_);
+
+    VisualizationSnapshotPtr_t published = std::move(backSnapshot_);
+    backSnapshot_ = acquireSnapshot();
+
+    // waiters check the front snapshot under the mutex, so passing through
+    // it after the store ensures no wakeup is lost
+    {
+        std::lock_guard<std::mutex> lock(publishMutex_);
+    }
+    notifyReaders();
+
+    return published;
+}
+
+void SnapshotPublisher::finish()
+{
+    {
+        std::lock_guard<std::mutex> lock(publishMutex_);
+        finished_ = true;
+    }
+    notifyReaders();
+}
+
+bool SnapshotPublisher::isFinished() const
+{
+    std::lock_guard<std::mutex> lock(publishMutex_);
+    return finished_;
+}
+
+void SnapshotPublisher::notifyReaders()
+{
+    publishCondition_.notify_all();
+    if (publishCallback_)
+        publishCallback_();
+}
+
+std::shared_ptr<VisualizationSnapshot> SnapshotPublisher::acquireSnapshot()
+{
+    // A snapshot only referenced by the pool is neither published nor held
+    // by a reader. Nobody can acquire a new reference to it, so a use count
+    // of one is stable.
+    for (const auto& snapshot : snapshotPool_)
+    {
+        if (snapshot.use_count() == 1)
+        {
+            // synchronize with the release of the last reader
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return snapshot;
+        }
+    }
+
+    // all snapshots are in use, e.g. kept by a slow reader
+    snapshotPool_.push_back(std::make_shared<VisualizationSnapshot>());
+    snapshotPool_.back()->data = allocateSnapshotData(layout_);
+    return snapshotPool_.back();
+}
+
+VisualizationSnapshotPtr_t SnapshotPublisher::getLatest() const
+{
+    return std::atomic_load(&frontSnapshot_);
+}
+
+VisualizationSnapshotPtr_t SnapshotPublisher::getHistorySnapshot(
+        uint64_t version) const
+{
+    if (0 == historyLength_)
+        return nullptr;
+
+    // the slot may already hold a newer version
+    VisualizationSnapshotPtr_t snapshot =
+        std::atomic_load(&history_[version % historyLength_]);
+    if ((nullptr == snapshot) || (snapshot->version != version))
+        return nullptr;
+
+    return snapshot;
+}
+
+uint64_t SnapshotPublisher::getOldestHistoryVersion(
+        uint64_t latestVersion) const
+{
+    if (0 == historyLength_)
+        return latestVersion;
+    if (latestVersion < historyLength_)
+        return std::min<uint64_t>(1, latestVersion);
+
+    return latestVersion - historyLength_ + 1;
+}
+
+bool SnapshotPublisher::waitForData(
+        uint64_t version, std::chrono::milliseconds timeout) const
+{
+    std::unique_lock<std::mutex> lock(publishMutex_);
+    return publishCondition_.wait_for(
+        lock,
+        timeout,
+        [this, version](){
+            return finished_ ||
+                (std::atomic_load(&frontSnapshot_)->version != version);
+            }
+        );
+}
+
+void SnapshotPublisher::setPublishCallback(std::function<void()> callback)
+{
+    publishCallback_ = std::move(callback);
+}
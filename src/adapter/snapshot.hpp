@@ -0,0 +1,196 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <boost/multi_array.hpp>
+
+namespace inpreciceadapter {
+
+struct VisualizationDataInfo
+{
+    int meshID{-1};
+    std::vector<int> dataIDs{};
+    std::vector<std::string> dataNames{};
+    std::string meshName{""};
+
+    std::array< size_t, 2 > gridDimension{};
+    std::vector<int> vertexIDs{};
+    // single precision copies of the coupling data, one per data name, only
+    // allocated in snapshots
+    std::vector<boost::multi_array<float, 2> > buffers{};
+};
+
+std::ostream& operator<<(std::ostream& os, const VisualizationDataInfo& info);
+
+using VisualizationDataInfoVec_t = std::vector<VisualizationDataInfo>;
+
+/**
+ * \brief Creates the data of a snapshot with one buffer per data name, sized
+ *        to the grid dimension of the mesh
+ *
+ * \param layout  meshes and data names without buffers
+ */
+VisualizationDataInfoVec_t allocateSnapshotData(
+        const VisualizationDataInfoVec_t& layout);
+
+/**
+ * \brief Immutable set of coupling data published by the coupling thread
+ *
+ * A snapshot is never written to while it is published or held by a
+ * reader, so the renderer can read its buffers without locking and without
+ * copying. The version is increased by one for each published coupling step.
+ */
+struct VisualizationSnapshot
+{
+    uint64_t version{0};
+    VisualizationDataInfoVec_t data{};
+};
+
+using VisualizationSnapshotPtr_t = std::shared_ptr<const VisualizationSnapshot>;
+
+/**
+ * \brief Hands snapshots from a producer thread to readers without locking
+ *
+ * The producer fills a private back snapshot. Publishing it is a single
+ * atomic pointer store, after which a snapshot that no reader holds anymore
+ * is taken from a preallocated pool as the next back snapshot. Readers only
+ * ever see completely written snapshots. Optionally, the last published
+ * snapshots are kept in a ring buffer for browsing back in time.
+ */
+class SnapshotPublisher
+{
+    // Number of snapshots allocated up front in addition to the history:
+    // back and up to two held by the renderer while they are evicted from
+    // the history (or front, back and the one held by the renderer without
+    // history)
+    static constexpr size_t SNAPSHOT_POOL_SIZE = 3;
+
+    public:
+    SnapshotPublisher();
+    SnapshotPublisher( const SnapshotPublisher& ) = delete;
+    SnapshotPublisher& operator=( const SnapshotPublisher& ) = delete;
+
+    /**
+     * \brief Sets the number of published snapshots that are kept for
+     *        browsing back in time
+     *
+     * Has to be called before initialize(). A length of zero disables the
+     * history.
+     */
+    void setHistoryLength(size_t length);
+
+    /**
+     * \brief Preallocates all snapshots with the given layout
+     *
+     * \param layout          meshes and data names of the snapshots
+     * \param numHeldOutside  number of published snapshots that may be held
+     *                        by additional consumers, e.g. a recorder
+     *
+     * The initial front snapshot with version 0 holds zeroed buffers.
+     */
+    void initialize(
+            const VisualizationDataInfoVec_t& layout, size_t numHeldOutside);
+
+    /**
+     * \brief Returns the snapshot to be filled next (producer thread only)
+     */
+    VisualizationSnapshot& accessBackSnapshot() { return *backSnapshot_; }
+
+    /**
+     * \brief Publishes the back snapshot with the next version (producer
+     *        thread only)
+     *
+     * \return the published snapshot
+     */
+    VisualizationSnapshotPtr_t publish();
+
+    /**
+     * \brief Signals readers that no more snapshots will be published
+     */
+    void finish();
+
+    /**
+     * \brief Returns true after finish() was called
+     */
+    bool isFinished() const;
+
+    /**
+     * \brief Returns the most recently published snapshot
+     *
+     * The returned snapshot stays valid and unchanged as long as the caller
+     * holds the pointer. Safe to call concurrently to the producer.
+     */
+    VisualizationSnapshotPtr_t getLatest() const;
+
+    /**
+     * \brief Returns the snapshot of the given version from the history
+     *
+     * \return the snapshot or nullptr if the version is not or no longer
+     *         kept in the history
+     */
+    VisualizationSnapshotPtr_t getHistorySnapshot(uint64_t version) const;
+
+    /**
+     * \brief Returns the oldest version kept in the history when the given
+     *        version is the latest one
+     */
+    uint64_t getOldestHistoryVersion(uint64_t latestVersion) const;
+
+    /**
+     * \brief Blocks until a snapshot newer than the given version was
+     *        published, the producer has finished or the timeout expired
+     *
+     * \return false if the timeout expired, true otherwise
+     */
+    bool waitForData(
+            uint64_t version, std::chrono::milliseconds timeout) const;
+
+    /**
+     * \brief Sets a function that is called on the producer thread whenever
+     *        a new snapshot was published or the producer has finished
+     *
+     * Has to be set before the producer thread is started.
+     */
+    void setPublishCallback(std::function<void()> callback);
+
+    private:
+    VisualizationDataInfoVec_t layout_;
+
+    // Version of the last published snapshot (producer thread only)
+    uint64_t publishedVersion_;
+
+    // Latest published snapshot, only accessed with std::atomic_load/store
+    std::shared_ptr<VisualizationSnapshot> frontSnapshot_;
+    // Snapshot that is filled by the producer before publishing
+    std::shared_ptr<VisualizationSnapshot> backSnapshot_;
+    // All snapshots ever allocated, reused as soon as no reader holds them
+    // anymore (producer thread only after initialization)
+    std::vector< std::shared_ptr<VisualizationSnapshot> > snapshotPool_;
+
+    // Ring buffer of the last published snapshots, the snapshot of version v
+    // is stored at index v % historyLength_. Slots are only accessed with
+    // std::atomic_load/store.
+    size_t historyLength_;
+    std::vector< std::shared_ptr<VisualizationSnapshot> > history_;
+
+    // Signaling of published snapshots to waiting readers
+    mutable std::mutex publishMutex_;
+    mutable std::condition_variable publishCondition_;
+    // True after the last snapshot was published, guarded by publishMutex_
+    bool finished_;
+    // Called on the producer thread after each publish
+    std::function<void()> publishCallback_;
+
+    std::shared_ptr<VisualizationSnapshot> acquireSnapshot();
+    void notifyReaders();
+};
+
+} //namespace inpreciceadapter
@@ -0,0 +1,419 @@
+#include "vismesh.hpp"
+#include "binaryio.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include <json.hpp>
+using json = nlohmann::json;
+
+using namespace inpreciceadapter;
+using binaryio::readValue;
+
+constexpr char VisMeshFile::BINARY_MAGIC[8];
+constexpr uint32_t VisMeshFile::BINARY_VERSION;
+
+namespace {
+
+// size of the file header and of one entry in the mesh table in bytes
+constexpr size_t BINARY_HEADER_SIZE = 16;
+constexpr size_t BINARY_MESH_ENTRY_SIZE = 56;
+
+// minimum number of plane vertices for generating them multithreaded
+constexpr size_t PARALLEL_PLANE_MIN_VERTICES = 256 * 256;
+
+/**
+ * \brief Reads a zero terminated string and advances the offset behind it
+ */
+std::string readString(const char* data, size_t size, size_t& offset)
+{
+    if (offset >= size)
+        throw std::runtime_error("Vis-mesh file is truncated");
+
+    const void* end = std::memchr(data + offset, '\0', size - offset);
+    if (nullptr == end)
+        throw std::runtime_error("Vis-mesh file contains unterminated string");
+
+    std::string str(data + offset, static_cast<const char*>(end));
+    offset += str.size() + 1;
+    return str;
+}
+
+/**
+ * \brief Streaming parser for the json visualization mesh files
+ *
+ * Only the meshes of the selected benchmark case are kept. Vertex positions
+ * are written straight into the vertex storage of the mesh, no json values
+ * are built at all. Everything else, like the edges written by
+ * mesh-generator.py, is skipped while streaming over it.
+ */
+class VisMeshSaxHandler : public json::json_sax_t
+{
+    enum class Field { none, gridDimensions, mappingData, vertices, plane };
+
+    public:
+    VisMeshSaxHandler(
+            int bmCase,
+            std::vector<VisMesh>& meshes,
+            std::vector< std::vector<double> >& vertexStorage) :
+        bmCase_(bmCase),
+        caseKey_("case" + std::to_string(bmCase)),
+        meshDepth_((1 == bmCase) ? 1 : 2),
+        meshes_(meshes),
+        vertexStorage_(vertexStorage)
+    {
+    }
+
+    bool null() override { return true; }
+    bool boolean(bool) override { return true; }
+
+    bool number_integer(number_integer_t val) override
+    {
+        return (val < 0) ? number(static_cast<double>(val)) :
+            number(static_cast<size_t>(val));
+    }
+
+    bool number_unsigned(number_unsigned_t val) override
+    {
+        return number(static_cast<size_t>(val));
+    }
+
+    bool number_float(number_float_t val, const string_t&) override
+    {
+        return number(static_cast<double>(val));
+    }
+
+    bool string(string_t& val) override
+    {
+        if (inCase_ && (Field::mappingData == field_) &&
+                ((meshDepth_ + 1 == depth_) || (meshDepth_ + 2 == depth_)))
+            meshes_.back().dataNames.push_back(val);
+
+        return true;
+    }
+
+    bool start_object(std::size_t) override
+    {
+        if (inCase_ && (meshDepth_ == depth_))
+            beginMesh();
+
+        ++depth_;
+        return true;
+    }
+
+    bool key(string_t& val) override
+    {
+        if (1 == depth_)
+            inCase_ = (val == caseKey_);
+        else if (!inCase_)
+            return true;
+        else if ((2 == bmCase_) && (2 == depth_))
+            meshName_ = val;
+        else if (meshDepth_ + 1 == depth_)
+        {
+            if ("gridDimensions" == val)
+                field_ = Field::gridDimensions;
+            else if ("mappingData" == val)
+                field_ = Field::mappingData;
+            else if ("vertices" == val)
+                field_ = Field::vertices;
+            else if ("plane" == val)
+            {
+                field_ = Field::plane;
+                hasPlane_ = true;
+            }
+            else
+                field_ = Field::none;
+        }
+        else if ((Field::plane == field_) && (meshDepth_ + 2 == depth_))
+        {
+            planeVector_ = ("p" == val) ? 0 : ("u" == val) ? 1 :
+                ("v" == val) ? 2 : NO_PLANE_VECTOR;
+            numPlaneComponents_ = 0;
+        }
+        else if ((Field::vertices == field_) && (meshDepth_ + 3 == depth_))
+            inPos_ = ("pos" == val);
+
+        return true;
+    }
+
+    bool end_object() override
+    {
+        --depth_;
+        if (inCase_ && (meshDepth_ == depth_))
+            endMesh();
+        else if (inCase_ && (meshDepth_ + 2 == depth_))
+            inPos_ = false;
+
+        return true;
+    }
+
+    bool start_array(std::size_t) override
+    {
+        ++depth_;
+        return true;
+    }
+
+    bool end_array() override
+    {
+        --depth_;
+
+        // the vertex storage can be sized once the grid is known
+        if (inCase_ && (Field::gridDimensions == field_) &&
+                (meshDepth_ + 1 == depth_))
+            vertexStorage_.back().reserve(
+                3 * meshes_.back().getNumVertices());
+
+        return true;
+    }
+
+    bool parse_error(
+            std::size_t,
+            const std::string&,
+            const nlohmann::detail::exception& ex) override
+    {
+        throw std::runtime_error(
+            std::string("Parsing of vis-mesh file failed: ") + ex.what());
+    }
+
+    private:
+    const int bmCase_;
+    const std::string caseKey_;
+    // number of open objects and arrays around a mesh object
+    const size_t meshDepth_;
+
+    std::vector<VisMesh>& meshes_;
+    std::vector< std::vector<double> >& vertexStorage_;
+
+    // current position in the document
+    size_t depth_{0};
+    bool inCase_{false};
+    std::string meshName_{""};
+    Field field_{Field::none};
+    bool inPos_{false};
+    size_t numGridDimensions_{0};
+
+    // parametric description of a regular plane (p, u, v)
+    static constexpr size_t NO_PLANE_VECTOR = 3;
+    bool hasPlane_{false};
+    std::array< std::array<double, 3>, 3 > plane_{};
+    size_t planeVector_{NO_PLANE_VECTOR};
+    size_t numPlaneComponents_{0};
+
+    bool number(size_t val)
+    {
+        if (inCase_ && (Field::gridDimensions == field_) &&
+                (meshDepth_ + 2 == depth_))
+        {
+            if (numGridDimensions_ < 2)
+                meshes_.back().gridDimension[numGridDimensions_] = val;
+            ++numGridDimensions_;
+            return true;
+        }
+
+        return number(static_cast<double>(val));
+    }
+
+    bool number(double val)
+    {
+        if (!inCase_)
+            return true;
+
+        if (inPos_ && (meshDepth_ + 4 == depth_))
+            vertexStorage_.back().push_back(val);
+        else if ((Field::plane == field_) && (meshDepth_ + 3 == depth_) &&
+                (NO_PLANE_VECTOR != planeVector_) && (numPlaneComponents_ < 3))
+            plane_[planeVector_][numPlaneComponents_++] = val;
+
+        return true;
+    }
+
+    void beginMesh()
+    {
+        meshes_.emplace_back();
+        meshes_.back().meshName =
+            (1 == bmCase_) ? std::string("VisualizationMesh") : meshName_;
+        vertexStorage_.emplace_back();
+
+        field_ = Field::none;
+        inPos_ = false;
+        numGridDimensions_ = 0;
+        hasPlane_ = false;
+        plane_ = {};
+        planeVector_ = NO_PLANE_VECTOR;
+    }
+
+    void endMesh()
+    {
+        VisMesh& mesh = meshes_.back();
+        std::vector<double>& gridPoints = vertexStorage_.back();
+
+        const size_t numPoints = mesh.getNumVertices();
+        if (hasPlane_ && gridPoints.empty())
+        {
+            gridPoints.resize(3 * numPoints);
+            makeRegularPlane(
+                plane_[0],
+                plane_[1],
+                plane_[2],
+                mesh.gridDimension,
+                gridPoints.data());
+        }
+
+        if (gridPoints.size() < 3 * numPoints)
+            throw std::runtime_error(
+                "Vis-mesh file contains too few vertices for mesh " +
+                mesh.meshName);
+        gridPoints.resize(3 * numPoints);
+        mesh.vertices = gridPoints.data();
+
+        field_ = Field::none;
+    }
+};
+
+} // namespace
+
+void inpreciceadapter::makeRegularPlane(
+        const std::array<double, 3>& p,
+        const std::array<double, 3>& u,
+        const std::array<double, 3>& v,
+        const std::array< size_t, 2 >& gridDimension,
+        double* vertices)
+{
+    const size_t nx = gridDimension[0];
+    const size_t ny = gridDimension[1];
+
+    // step between neighboring vertices, evaluated in the same order as in
+    // mesh-generator.py to get identical coordinates
+    std::array<double, 3> mx{}, my{};
+    for (size_t k = 0; k < 3; ++k)
+    {
+        mx[k] = (nx > 1) ? u[k] / static_cast<double>(nx - 1) : 0.;
+        my[k] = (ny > 1) ? v[k] / static_cast<double>(ny - 1) : 0.;
+    }
+
+    #pragma omp parallel for if(nx * ny >= PARALLEL_PLANE_MIN_VERTICES)
+    for (size_t iy = 0; iy < ny; ++iy)
+    {
+        const double y = static_cast<double>(iy);
+        double* row = vertices + 3 * iy * nx;
+
+        #pragma omp simd
+        for (size_t ix = 0; ix < nx; ++ix)
+        {
+            const double x = static_cast<double>(ix);
+            row[3 * ix] = (p[0] + x * mx[0]) + y * my[0];
+            row[3 * ix + 1] = (p[1] + x * mx[1]) + y * my[1];
+            row[3 * ix + 2] = (p[2] + x * mx[2]) + y * my[2];
+        }
+    }
+}
+
+void VisMeshFile::open(const std::string& path, int bmCase)
+{
+    meshes_.clear();
+    vertexStorage_.clear();
+    if (mappedFile_.is_open())
+        mappedFile_.close();
+
+    char magic[sizeof(BINARY_MAGIC)] = {};
+    {
+        std::ifstream fs(
+            path.c_str(), std::ifstream::in | std::ifstream::binary);
+        if (!fs.good())
+            throw std::runtime_error("Could not open vis-mesh file " + path);
+        fs.read(magic, sizeof(magic));
+    }
+
+    if (0 == std::memcmp(magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)))
+        openBinary(path, bmCase);
+    else
+        openJson(path, bmCase);
+
+    if (meshes_.empty())
+        throw std::runtime_error(
+            "Vis-mesh file " + path + " contains no meshes for case " +
+            std::to_string(bmCase));
+}
+
+void VisMeshFile::openBinary(const std::string& path, int bmCase)
+{
+    mappedFile_.open(path);
+    const char* data = mappedFile_.data();
+    const size_t size = mappedFile_.size();
+
+    if (BINARY_VERSION != readValue<uint32_t>(data, size, 8))
+        throw std::runtime_error("Unsupported vis-mesh file version");
+    const uint32_t numMeshes = readValue<uint32_t>(data, size, 12);
+
+    for (uint32_t m = 0; m < numMeshes; ++m)
+    {
+        const size_t entry = BINARY_HEADER_SIZE + m * BINARY_MESH_ENTRY_SIZE;
+        if (static_cast<uint32_t>(bmCase) !=
+                readValue<uint32_t>(data, size, entry))
+            continue;
+
+        VisMesh mesh;
+        const uint32_t numDataNames =
+            readValue<uint32_t>(data, size, entry + 4);
+        mesh.gridDimension[0] = readValue<uint64_t>(data, size, entry + 8);
+        mesh.gridDimension[1] = readValue<uint64_t>(data, size, entry + 16);
+
+        size_t nameOffset = readValue<uint64_t>(data, size, entry + 24);
+        mesh.meshName = readString(data, size, nameOffset);
+
+        size_t dataNamesOffset = readValue<uint64_t>(data, size, entry + 32);
+        mesh.dataNames.reserve(numDataNames);
+        for (uint32_t i = 0; i < numDataNames; ++i)
+            mesh.dataNames.push_back(readString(data, size, dataNamesOffset));
+
+        // the mapping is page aligned, so an aligned offset yields properly
+        // aligned doubles that can be passed on without copying
+        const size_t verticesOffset =
+            readValue<uint64_t>(data, size, entry + 40);
+        const size_t verticesSize = 3 * sizeof(double) * mesh.getNumVertices();
+        if ((0 != verticesOffset % alignof(double)) ||
+                (verticesOffset > size) ||
+                (verticesSize > size - verticesOffset))
+            throw std::runtime_error(
+                "Vis-mesh file contains invalid vertex block for mesh " +
+                mesh.meshName);
+        if (!binaryio::isBigEndianHost())
+            mesh.vertices =
+                reinterpret_cast<const double*>(data + verticesOffset);
+        else
+        {
+            // the file is little endian, so big endian hosts need a
+            // byte swapped copy of the vertices
+            vertexStorage_.emplace_back(3 * mesh.getNumVertices());
+            std::vector<double>& vertices = vertexStorage_.back();
+            for (size_t i = 0; i < vertices.size(); ++i)
+                vertices[i] = readValue<double>(
+                    data, size, verticesOffset + i * sizeof(double));
+            mesh.vertices = vertices.data();
+        }
+
+        meshes_.push_back(std::move(mesh));
+    }
+}
+
+void VisMeshFile::openJson(const std::string& path, int bmCase)
+{
+    std::ifstream fs;
+    fs.open(path.c_str(), std::ifstream::in);
+
+    VisMeshSaxHandler handler(bmCase, meshes_, vertexStorage_);
+    json::sax_parse(fs, &handler);
+
+    // the adapter expects the meshes of a case ordered by name
+    std::sort(
+        meshes_.begin(),
+        meshes_.end(),
+        [](const VisMesh& a, const VisMesh& b){
+            return a.meshName < b.meshName;
+            }
+        );
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+namespace inpreciceadapter {
+
+/**
+ * \brief Description of a single visualization mesh
+ *
+ * The vertices are stored as contiguous xyz triplets in row-major grid order
+ * and can be handed to preCICE directly. They point either into a memory
+ * mapped binary mesh file or into storage owned by the VisMeshFile.
+ */
+struct VisMesh
+{
+    std::string meshName{""};
+    std::array< size_t, 2 > gridDimension{};
+    std::vector<std::string> dataNames{};
+    const double* vertices{nullptr};
+
+    size_t getNumVertices() const
+    {
+        return gridDimension[0] * gridDimension[1];
+    }
+};
+
+/**
+ * \brief Generates the vertices of a regular plane
+ *
+ * \param p              origin of the plane
+ * \param u              span vector along the first grid dimension
+ * \param v              span vector along the second grid dimension
+ * \param gridDimension  number of vertices along u and v
+ * \param vertices       output for the xyz triplets of all vertices, has to
+ *                       hold 3 * gridDimension[0] * gridDimension[1] values
+ *
+ * Produces the same vertex order and coordinates as makeRegularPlane3D in
+ * scripts/mesh-generator.py.
+ */
+void makeRegularPlane(
+        const std::array<double, 3>& p,
+        const std::array<double, 3>& u,
+        const std::array<double, 3>& v,
+        const std::array< size_t, 2 >& gridDimension,
+        double* vertices);
+
+/**
+ * \brief Visualization meshes of one benchmark case
+ *
+ * Reads either the binary mesh container written by
+ * scripts/vis-mesh-converter.py or the legacy json file written by
+ * scripts/mesh-generator.py. The file type is detected from the magic bytes
+ * at the start of the file. Json files are parsed in a streaming fashion
+ * without building a document in memory. Instead of a vertex list, a json
+ * mesh may describe a regular plane by "plane": {"p", "u", "v"}, whose
+ * vertices are then generated with makeRegularPlane().
+ *
+ * Binary layout (little endian):
+ *   header:      char magic[8] = "IPCVMESH", uint32 version, uint32 numMeshes
+ *   mesh table:  numMeshes entries of
+ *                  uint32 bmCase, uint32 numDataNames,
+ *                  uint64 gridDimension[2],
+ *                  uint64 nameOffset, uint64 dataNamesOffset,
+ *                  uint64 verticesOffset, uint64 reserved
+ *   strings:     zero terminated, data names are stored back to back
+ *   vertices:    8 byte aligned float64 xyz block per mesh
+ *
+ * All offsets are relative to the start of the file. The vertices are
+ * used straight from the mapping, only big endian hosts copy them.
+ */
+class VisMeshFile
+{
+    public:
+    static constexpr char BINARY_MAGIC[8] =
+        { 'I', 'P', 'C', 'V', 'M', 'E', 'S', 'H' };
+    static constexpr uint32_t BINARY_VERSION = 1;
+
+    VisMeshFile() = default;
+    VisMeshFile( const VisMeshFile& ) = delete;
+    VisMeshFile& operator=( const VisMeshFile& ) = delete;
+
+    /**
+     * \brief Loads the visualization meshes of the given benchmark case
+     *
+     * Throws std::runtime_error if the file can not be read or is malformed.
+     */
+    void open(const std::string& path, int bmCase);
+
+    const std::vector<VisMesh>& getMeshes() const { return meshes_; }
+
+    private:
+    // Memory mapping of a binary mesh file
+    boost::iostreams::mapped_file_source mappedFile_;
+    // Vertex storage for meshes that can not be used from the mapping
+    std::vector< std::vector<double> > vertexStorage_;
+
+    std::vector<VisMesh> meshes_;
+
+    void openBinary(const std::string& path, int bmCase);
+    void openJson(const std::string& path, int bmCase);
+};
+
+} //namespace inpreciceadapter
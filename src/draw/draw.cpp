@@ -1,7 +1,10 @@
 #include <iostream>
+#include <algorithm>
+#include <cstdio>
 #include <cstdlib>
 #include <ctime>
 #include <functional>
+#include <numeric>
 
 #include <GL/gl3w.h>
 #include <GLFW/glfw3.h>
@@ -19,6 +22,7 @@
 #include "shader.hpp"
 
 #include "util/util.hpp"
+#include "trace/trace.hpp"
 
 #define REQUIRED_OGL_VERSION_MAJOR 3
 #define REQUIRED_OGL_VERSION_MINOR 3
@@ -39,12 +43,26 @@ draw::Renderer::Renderer() :
     m_window(nullptr),
     m_windowDimensions{ {1280, 720} },
     m_isInitialized(false),
+    m_eventDriven(false),
+    m_headless(false),
     // common visualization parameters
     m_cmClipMin(0.f),
     m_cmClipMax(1.f),
     m_cmSelect(0),
     m_isovalueInterval(0.1f),
     m_isolineColor({0.f, 0.f, 0.f}),
+    m_isovalues(),
+    m_isolineMode(static_cast<int>(IsolineMode::cpu)),
+    m_renderedDataGeneration(INVALID_DATA_GENERATION),
+    m_viewDirty(true),
+    m_fracturesDirty(true),
+    m_isolinesDirty(true),
+    m_dataTextures(),
+    m_dataDimensions(),
+    m_minMaxPyramids(),
+    m_uploadMode(static_cast<int>(UploadMode::synchronous)),
+    m_uploadRing(),
+    m_isolineBatches(),
     // fracture network geometry
     m_fractureNetwork{
         false, false, false, false, false, false, false, false, false},
@@ -62,7 +80,9 @@ draw::Renderer::Renderer() :
     m_cameraTranslationSpeed(0.002f),
     m_3dViewMx(1.f),
     m_3dProjMx(1.f),
-    m_fractureFbo(),
+    m_fractureTextures(),
+    m_fractureFbos(),
+    m_fractureGenerations(),
     m_planeShader(),
     m_frameShader(),
     m_volumeFrame(false),
@@ -75,7 +95,20 @@ draw::Renderer::Renderer() :
     m_isolineShader(),
     m_windowQuad(false),
     m_quadProjMx(glm::ortho(-0.5f, 0.5f, -0.5f, 0.5f)),
-    m_showDemoWindow(false)
+    m_oldestStep(0),
+    m_latestStep(0),
+    m_selectedStep(0),
+    m_followLatestStep(true),
+    m_showDemoWindow(false),
+    m_gpuTimer(),
+    m_frameBegin(),
+    m_cpuFrameTimes(),
+    m_cpuFrameTimesPos(0),
+    m_numCpuFrameTimes(0),
+    m_frameCapture(),
+    m_captureEveryFrame(false),
+    m_capturePrefix(),
+    m_numCapturedFrames(0)
 {
     // nothing to see here
 }
@@ -89,6 +122,9 @@ draw::Renderer::Renderer(unsigned int winWidth, unsigned int winHeight) :
 
 draw::Renderer::~Renderer()
 {
+    // pending readbacks still need the context
+    m_frameCapture.reset();
+
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
@@ -111,6 +147,13 @@ int draw::Renderer::initialize()
     //-------------------------------------------------------------------------
     m_window = createWindow(
         m_windowDimensions[0], m_windowDimensions[1], "inpreCICE");
+    if (nullptr == m_window)
+    {
+        std::cerr << "Error: Could not create an OpenGL "
+            << REQUIRED_OGL_VERSION_MAJOR << "." << REQUIRED_OGL_VERSION_MINOR
+            << " context!" << std::endl;
+        return EXIT_FAILURE;
+    }
 
     ret = initializeGl3w();
     if (EXIT_SUCCESS != ret) return ret;
@@ -218,10 +261,23 @@ int draw::Renderer::initialize()
             1,
             static_cast<void const *>(&SMOOTHCOOLWARM_FLOAT_RGB_128[0]));
 
+    m_uploadRing = util::texture::PixelUnpackBufferRing(
+            PIXEL_BUFFER_RING_SIZE);
+
+    // batch images must not be dropped
+    m_frameCapture = std::make_unique<util::FrameCapture>();
+    m_frameCapture->setWaitForWriter(m_headless);
+
+    // names of the RenderPass values
+    m_gpuTimer = util::GpuTimer({
+            "upload", "colormap", "isolines", "composite", "present",
+            "imgui"});
+
     //-------------------------------------------------------------------------
     // framebuffer objects for deferred shading
     //-------------------------------------------------------------------------
     updateFramebufferObjects();
+    createFractureRenderTargets();
 
     if (EXIT_SUCCESS == ret)
         m_isInitialized = true;
@@ -240,7 +296,10 @@ bool draw::Renderer::processEvents()
         return false;
     }
 
-    glfwPollEvents();
+    if (m_eventDriven)
+        glfwWaitEventsTimeout(EVENT_WAIT_TIMEOUT);
+    else
+        glfwPollEvents();
     processInput();
 
     if (!glfwWindowShouldClose(m_window))
@@ -253,7 +312,7 @@ bool draw::Renderer::processEvents()
 
 //-----------------------------------------------------------------------------
 int draw::Renderer::drawSingleFracture(
-        const boost::multi_array<double, 2> &data)
+        const fractureData_t &data, uint64_t dataGeneration)
 {
     if (false == m_isInitialized)
     {
@@ -263,101 +322,43 @@ int draw::Renderer::drawSingleFracture(
         return EXIT_FAILURE;
     }
 
-    // create texture from sample data
-    boost::multi_array<float, 2> dataTexture(
-            boost::extents[data.shape()[0]][data.shape()[1]]);
-    for (size_t y = 0; y < data.shape()[0]; ++y)
-    for (size_t x = 0; x < data.shape()[1]; ++x)
-        dataTexture[y][x] = static_cast<float>(data[y][x]);
+    beginFrame();
 
-    util::texture::Texture2D fractureTex(
-            GL_R32F,
-            GL_RED,
-            0,
-            GL_FLOAT,
-            GL_LINEAR,
-            GL_CLAMP_TO_EDGE,
-            dataTexture.shape()[1],
-            dataTexture.shape()[0],
-            static_cast<void const*>(dataTexture.data()));
+    // nothing changed since the last frame, only present the cached result
+    const bool dataChanged = (dataGeneration != m_renderedDataGeneration);
+    if (!dataChanged && !m_viewDirty && !m_fracturesDirty)
+        return presentFrame();
 
-    glViewport(0, 0, m_windowDimensions[0], m_windowDimensions[1]);
-    m_framebuffer.bind();
-    glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+    TRACE_SCOPE("drawSingleFracture");
 
-    // draw the data into the framebuffer object
-    m_fractureShader.use();
-    m_fractureShader.setMat4("projMX", m_quadProjMx);
-    m_fractureShader.setFloat("tfMin", m_cmClipMin);
-    m_fractureShader.setFloat("tfMax", m_cmClipMax);
-
-    glActiveTexture(GL_TEXTURE0);
-    fractureTex.bind();
-    m_fractureShader.setInt("sampleTex", 0);
-
-    glActiveTexture(GL_TEXTURE1);
-    if (m_cmSelect == 0)
-        m_smoothcoolwarmMap.bind();
-    else
-        m_viridisMap.bind();
-    m_fractureShader.setInt("tfTex", 1);
-
-    m_windowQuad.draw();
-
-    glm::mat3 pvmMx = glm::transpose(glm::mat3(
-            2.f / (dataTexture.shape()[0] - 1.f), 0.f, -1.0f,
-            0.f, 2.f / (dataTexture.shape()[1] -1.f), -1.0f,
-            0.f, 0.f, 1.f));
-
-    glClear(GL_DEPTH_BUFFER_BIT );
-    glLineWidth(2.f);
-    m_isolineShader.use();
-    m_isolineShader.setMat3("pvmMx", pvmMx);
-    for (
-            float isovalue = m_cmClipMin;
-            isovalue < m_cmClipMax;
-            isovalue += m_isovalueInterval)
+    // update the texture from sample data
+    if (dataChanged)
     {
-        std::vector<util::geometry::Line2D> isolines =
-            util::extractIsolines(dataTexture, isovalue);
-        glm::vec4 color = glm::vec4(
-                glm::vec3(
-                    m_isolineColor[0], m_isolineColor[1], m_isolineColor[2]),
-                1.f);
-        m_isolineShader.setVec4("linecolor", color);
-
-        for (auto &line : isolines)
-            line.draw();
+        TRACE_SCOPE("upload");
+        util::GpuTimer::Scope gpuScope(
+            m_gpuTimer, static_cast<size_t>(RenderPass::upload));
+        updateDataTexture(0, data);
     }
+    updateIsovalues();
 
-    // show the rendering result as window filling quad
     glViewport(0, 0, m_windowDimensions[0], m_windowDimensions[1]);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    m_framebuffer.bind();
     glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
 
-    m_windowShader.use();
-    m_windowShader.setMat4("projMX", m_quadProjMx);
-
-    glActiveTexture(GL_TEXTURE0);
-    m_framebuffer.accessTextures()[0].bind();
-    m_windowShader.setInt("renderTex", 0);
-
-    m_windowQuad.draw();
-
-    renderImgui();
-
-    glfwSwapBuffers(m_window);
+    // draw the data into the framebuffer object
+    drawFractureData(0, data, dataChanged || m_isolinesDirty);
 
+    m_renderedDataGeneration = dataGeneration;
+    m_viewDirty = false;
+    m_fracturesDirty = false;
+    m_isolinesDirty = false;
 
-    if (printOpenGLError())
-        return EXIT_FAILURE;
-    else
-        return EXIT_SUCCESS;
+    return presentFrame();
 }
 
 //-----------------------------------------------------------------------------
 int draw::Renderer::drawFractureNetwork(
-        const fractureDataArray_t &dataArray)
+        const fractureDataArray_t &dataArray, uint64_t dataGeneration)
 {
     if (false == m_isInitialized)
     {
@@ -367,141 +368,134 @@ int draw::Renderer::drawFractureNetwork(
         return EXIT_FAILURE;
     }
 
-    // render the nine fractures into a frame buffer object
+    beginFrame();
+
+    // nothing changed since the last frame, only present the cached result
+    const bool dataChanged = (dataGeneration != m_renderedDataGeneration);
+    if (!dataChanged && !m_viewDirty && !m_fracturesDirty)
+        return presentFrame();
+
+    TRACE_SCOPE("drawFractureNetwork");
+
+    updateIsovalues();
+
+    // render the color mapped fractures into their cached texture layers,
+    // only for fractures whose data or visualization settings changed
     for (size_t i = 0; i < 9; ++i)
     {
-        // create a texture from the sampled data
-        const boost::multi_array<double, 2>& data = dataArray[i];
-        boost::multi_array<float, 2> dataTexture(
-                boost::extents[data.shape()[0]][data.shape()[1]]);
-        for (size_t y = 0; y < data.shape()[0]; ++y)
-        for (size_t x = 0; x < data.shape()[1]; ++x)
-            dataTexture[y][x] = static_cast<float>(data[y][x]);
-        util::texture::Texture2D sampleTex(
-                GL_R32F,
-                GL_RED,
-                0,
-                GL_FLOAT,
-                GL_LINEAR,
-                GL_CLAMP_TO_EDGE,
-                dataTexture.shape()[1],
-                dataTexture.shape()[0],
-                static_cast<void const*>(dataTexture.data()));
+        const bool fractureDataChanged =
+            (dataGeneration != m_fractureGenerations[i]);
+        if (!fractureDataChanged && !m_fracturesDirty)
+            continue;
 
-        // render the fracture into a 2D texture
+        // update the texture from the sampled data
+        if (fractureDataChanged)
+        {
+            TRACE_SCOPE("upload");
+            util::GpuTimer::Scope gpuScope(
+                m_gpuTimer, static_cast<size_t>(RenderPass::upload));
+            updateDataTexture(i, dataArray[i]);
+        }
+
+        // render the fracture into its layer of the fracture textures
         glViewport(
             0,
             0,
             FRACTURE_TEXTURE_RESOLUTION[0],
             FRACTURE_TEXTURE_RESOLUTION[1]);
-        m_fractureFbo.bind();
+        m_fractureFbos[i].bind();
         glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
 
-        m_fractureShader.use();
-        m_fractureShader.setMat4("projMX", m_quadProjMx);
-        m_fractureShader.setFloat("tfMin", m_cmClipMin);
-        m_fractureShader.setFloat("tfMax", m_cmClipMax);
-
-        glActiveTexture(GL_TEXTURE0);
-        sampleTex.bind();
-        m_fractureShader.setInt("sampleTex", 0);
+        drawFractureData(
+            i, dataArray[i], fractureDataChanged || m_isolinesDirty);
+        m_fractureFbos[i].unbind();
 
-        glActiveTexture(GL_TEXTURE1);
-        if (m_cmSelect == 0)
-            m_smoothcoolwarmMap.bind();
-        else
-            m_viridisMap.bind();
-        m_fractureShader.setInt("tfTex", 1);
-
-        m_windowQuad.draw();
-
-        glm::mat3 pvmMx = glm::transpose(glm::mat3(
-                2.f / (dataTexture.shape()[0] - 1.f), 0.f, -1.0f,
-                0.f, 2.f / (dataTexture.shape()[1] -1.f), -1.0f,
-                0.f, 0.f, 1.f));
-
-        glLineWidth(2.f);
-        m_isolineShader.use();
-        m_isolineShader.setMat3("pvmMx", pvmMx);
-        for (
-                float isovalue = m_cmClipMin;
-                isovalue < m_cmClipMax;
-                isovalue += m_isovalueInterval)
-        {
-            std::vector<util::geometry::Line2D> isolines =
-                util::extractIsolines(dataTexture, isovalue);
-            glm::vec4 color = glm::vec4(
-                    glm::vec3(
-                        m_isolineColor[0],
-                        m_isolineColor[1],
-                        m_isolineColor[2]),
-                    1.f);
-            m_isolineShader.setVec4("linecolor", color);
-
-            for (auto &line : isolines)
-                line.draw();
-        }
-        m_fractureFbo.unbind();
+        m_fractureGenerations[i] = dataGeneration;
+    }
 
-        // map the fracture texture onto the according 3D plane and
-        // draw it into the combined framebuffer object
+    // map the fracture textures onto the according 3D planes and
+    // draw them into the combined framebuffer object
+    {
+        TRACE_SCOPE("composite");
+        util::GpuTimer::Scope gpuScope(
+            m_gpuTimer, static_cast<size_t>(RenderPass::composite));
         glViewport(0, 0, m_windowDimensions[0], m_windowDimensions[1]);
         m_framebuffer.bind();
-        if (i == 0) glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+        glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
 
-        // draw the data into the framebuffer object
         m_planeShader.use();
 
         glActiveTexture(GL_TEXTURE0);
-        m_fractureFbo.accessTextures()[0].bind();
+        m_fractureTextures.bind();
         m_planeShader.setInt("fractureTex", 0);
 
-        m_planeShader.setMat4("pvmMx",
-            m_3dProjMx * m_3dViewMx * m_fractureModelMxs[i]);
-
         const glm::vec3 lightDir = glm::normalize(glm::vec3(1.f, 5.f, 1.f));
         m_planeShader.setVec3(
-                "lightDir", lightDir[0], lightDir[1], lightDir[2]);
+            "lightDir", lightDir[0], lightDir[1], lightDir[2]);
 
+        for (size_t i = 0; i < 9; ++i)
+        {
+            m_planeShader.setInt("fractureLayer", static_cast<int>(i));
+            m_planeShader.setMat4("pvmMx",
+                m_3dProjMx * m_3dViewMx * m_fractureModelMxs[i]);
 
-        m_fractureNetwork[i].draw();
-
-    }
-    // draw a frame around the domain
-    glLineWidth(2.f);
-    const glm::mat4 frameModelMx =
-        glm::translate(glm::mat4(1.f), glm::vec3(0.5f));
-    m_frameShader.use();
-    m_frameShader.setMat4("pvmMX", m_3dProjMx * m_3dViewMx * frameModelMx);
-    m_frameShader.setVec4("linecolor", 0.2f, 0.2f, 0.2f, 1.f);
+            m_fractureNetwork[i].draw();
+        }
 
-    m_volumeFrame.draw();
+        // draw a frame around the domain
+        glLineWidth(2.f);
+        const glm::mat4 frameModelMx =
+            glm::translate(glm::mat4(1.f), glm::vec3(0.5f));
+        m_frameShader.use();
+        m_frameShader.setMat4(
+            "pvmMX", m_3dProjMx * m_3dViewMx * frameModelMx);
+        m_frameShader.setVec4("linecolor", 0.2f, 0.2f, 0.2f, 1.f);
 
-    m_framebuffer.unbind();
+        m_volumeFrame.draw();
 
-    // show the rendering result as window filling quad
-    glViewport(0, 0, m_windowDimensions[0], m_windowDimensions[1]);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+        m_framebuffer.unbind();
+    }
 
-    m_windowShader.use();
-    m_windowShader.setMat4("projMX", m_quadProjMx);
+    m_renderedDataGeneration = dataGeneration;
+    m_viewDirty = false;
+    m_fracturesDirty = false;
+    m_isolinesDirty = false;
 
-    glActiveTexture(GL_TEXTURE0);
-    m_framebuffer.accessTextures()[0].bind();
-    m_windowShader.setInt("renderTex", 0);
+    return presentFrame();
+}
 
-    m_windowQuad.draw();
+//-----------------------------------------------------------------------------
+int draw::Renderer::saveFrame(const std::string &file)
+{
+    if (false == m_isInitialized)
+    {
+        std::cerr << "Error: Renderer::initialize() must be called "
+            "successfully before Renderer::saveFrame(...) can be used!" <<
+            std::endl;
+        return EXIT_FAILURE;
+    }
 
-    renderImgui();
+    m_frameCapture->capture(
+        m_framebuffer,
+        m_windowDimensions[0],
+        m_windowDimensions[1],
+        file,
+        FIF_PNG);
 
-    glfwSwapBuffers(m_window);
+    return EXIT_SUCCESS;
+}
 
+//-----------------------------------------------------------------------------
+int draw::Renderer::finishFrameCapture()
+{
+    if (nullptr == m_frameCapture)
+        return EXIT_SUCCESS;
 
-    if (printOpenGLError())
+    m_frameCapture->close();
+    if (m_frameCapture->getNumFailedFrames() > 0)
         return EXIT_FAILURE;
-    else
-        return EXIT_SUCCESS;
+
+    return EXIT_SUCCESS;
 }
 
 //-----------------------------------------------------------------------------
@@ -547,15 +541,36 @@ GLFWwindow* draw::Renderer::createWindow(
     unsigned int width, unsigned int height, const char* title)
 {
     glfwSetErrorCallback(error_cb);
+
+    // compute nodes have no display server, GLFW 3.4 can render there into
+    // an OSMesa context, i.e. with Mesa's software rasterizer
+    const bool hasDisplay =
+        (nullptr != std::getenv("DISPLAY")) ||
+        (nullptr != std::getenv("WAYLAND_DISPLAY"));
+#ifdef GLFW_PLATFORM_NULL
+    if (m_headless && !hasDisplay)
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#endif
+
     if (!glfwInit()) exit(EXIT_FAILURE);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, REQUIRED_OGL_VERSION_MAJOR);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, REQUIRED_OGL_VERSION_MINOR);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (m_headless)
+    {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#ifdef GLFW_PLATFORM_NULL
+        if (!hasDisplay)
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+#endif
+    }
 
     GLFWwindow* window = glfwCreateWindow(
         width, height, title, nullptr, nullptr);
+    if (nullptr == window)
+        return nullptr;
     glfwMakeContextCurrent(window);
-    glfwSwapInterval(1);
+    glfwSwapInterval(m_headless ? 0 : 1);
 
     glfwSetWindowUserPointer(window, this);
 
@@ -573,6 +588,7 @@ GLFWwindow* draw::Renderer::createWindow(
 void draw::Renderer::reloadShaders()
 {
     std::cout << "Reloading shaders..." << std::endl;
+    m_fracturesDirty = true;
     m_windowShader = Shader(
             "src/draw/shader/windowQuad.vert",
             "src/draw/shader/windowQuad.frag");
@@ -590,6 +606,34 @@ void draw::Renderer::reloadShaders()
             "src/draw/shader/frame.frag");
 }
 
+/**
+ * \brief Starts or stops capturing every presented frame into
+ *        ./screenshots/capture_<date>_<frame>.png
+ */
+void draw::Renderer::toggleCapture()
+{
+    m_captureEveryFrame = !m_captureEveryFrame;
+    if (!m_captureEveryFrame)
+    {
+        std::cout << "Captured " << m_numCapturedFrames << " frames to "
+            << m_capturePrefix << "_*.png" << std::endl;
+        return;
+    }
+
+    std::time_t t = std::time(nullptr);
+    std::tm* tm = std::localtime(&t);
+    char prefix[200];
+
+    strftime(
+            prefix,
+            sizeof(prefix),
+            "./screenshots/capture_%F_%H%M%S",
+            tm);
+
+    m_capturePrefix = prefix;
+    m_numCapturedFrames = 0;
+}
+
 // from imgui_demo.cpp
 void draw::Renderer::createHelpMarker(const std::string description)
 {
@@ -611,26 +655,89 @@ void draw::Renderer::renderImgui(void)
     ImGui::NewFrame();
     ImGui::Begin("inpreCICE menu");
     {
-        ImGui::DragFloatRange2(
+        bool appearanceChanged = false;
+        bool isolinesChanged = false;
+
+        isolinesChanged |= ImGui::DragFloatRange2(
             "Transfer function interval", &m_cmClipMin, &m_cmClipMax, 0.001f);
         ImGui::Text("Select color map:");
-        ImGui::RadioButton("coolwarm", &m_cmSelect, 0); ImGui::SameLine();
-        ImGui::RadioButton("viridis", &m_cmSelect, 1);
-        ImGui::DragFloat(
+        appearanceChanged |= ImGui::RadioButton("coolwarm", &m_cmSelect, 0);
+        ImGui::SameLine();
+        appearanceChanged |= ImGui::RadioButton("viridis", &m_cmSelect, 1);
+        ImGui::Text("Texture upload:");
+        ImGui::RadioButton(
+            "synchronous",
+            &m_uploadMode,
+            static_cast<int>(UploadMode::synchronous));
+        ImGui::SameLine();
+        ImGui::RadioButton(
+            "PBO ring",
+            &m_uploadMode,
+            static_cast<int>(UploadMode::pixelBuffer));
+        isolinesChanged |= ImGui::DragFloat(
             "Isoline interval",
             &m_isovalueInterval,
             1e-5f,
             1e-5f,
             0.1f,
             "%.5f");
-        ImGui::ColorEdit3("Isoline color", m_isolineColor.data());
+        appearanceChanged |= ImGui::ColorEdit3(
+            "Isoline color", m_isolineColor.data());
+        ImGui::Text("Isoline rendering:");
+        isolinesChanged |= ImGui::RadioButton(
+            "CPU geometry",
+            &m_isolineMode,
+            static_cast<int>(IsolineMode::cpu));
+        ImGui::SameLine();
+        appearanceChanged |= ImGui::RadioButton(
+            "GPU shader",
+            &m_isolineMode,
+            static_cast<int>(IsolineMode::gpu));
+        ImGui::SameLine();
+        createHelpMarker(
+            "CPU geometry extracts the isolines with marching squares and "
+            "draws them as lines. GPU shader draws them per pixel in the "
+            "fracture shader, independent of the number of isovalues.");
+
+        // changes become visible with the next rendered frame
+        m_isolinesDirty |= isolinesChanged;
+        m_fracturesDirty |= appearanceChanged || isolinesChanged;
+
+        // only shown if older time steps are kept
+        if (m_latestStep > m_oldestStep)
+        {
+            ImGui::Separator();
+            ImGui::Text("Time step:");
+            ImGui::Checkbox("Follow latest", &m_followLatestStep);
+            if (ImGui::SliderScalar(
+                    "Step",
+                    ImGuiDataType_U64,
+                    &m_selectedStep,
+                    &m_oldestStep,
+                    &m_latestStep))
+                m_followLatestStep = false;
+            ImGui::SameLine();
+            createHelpMarker(
+                "Browse back through the recently received time steps. "
+                "The number of kept time steps is set with --history.");
+        }
         ImGui::Separator();
         ImGui::Checkbox("Demo Window", &m_showDemoWindow);
+        if (trace::isRecording())
+            ImGui::TextColored(
+                ImVec4(0.8f, 0.f, 0.f, 1.f),
+                "Recording trace, press F8 to save it");
+        if (m_captureEveryFrame)
+            ImGui::TextColored(
+                ImVec4(0.8f, 0.f, 0.f, 1.f),
+                "Capturing frames, press Ctrl+F9 to stop");
         ImGui::Separator();
         ImGui::Text(
             "Application average %.3f ms/frame (%.1f FPS)",
             1000.0f / ImGui::GetIO().Framerate,
             ImGui::GetIO().Framerate);
+        if (ImGui::CollapsingHeader("Frame timing"))
+            renderTimingBreakdown();
     }
 
     if(m_showDemoWindow) ImGui::ShowDemoWindow(&m_showDemoWindow);
@@ -639,6 +746,68 @@ void draw::Renderer::renderImgui(void)
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }
 
+/**
+ * \brief Shows the CPU and GPU times of the last frames and the GPU time
+ *        of each render pass
+ */
+void draw::Renderer::renderTimingBreakdown()
+{
+    // slots of the rings that were not filled yet are zero
+    const size_t numFrames = m_cpuFrameTimes.size();
+    const float cpuAverage = std::accumulate(
+        m_cpuFrameTimes.cbegin(), m_cpuFrameTimes.cend(), 0.f) /
+        std::max<size_t>(m_numCpuFrameTimes, 1);
+    const std::array<float, util::GpuTimer::HISTORY_LENGTH>& gpuFrameTimes =
+        m_gpuTimer.getFrameTimes();
+    const float gpuAverage = m_gpuTimer.getAverageFrameTime();
+
+    ImGui::Text("CPU %.3f ms/frame, GPU %.3f ms/frame", cpuAverage, gpuAverage);
+    ImGui::SameLine();
+    createHelpMarker(
+        "Averages over the last frames. The CPU time is spent on drawing a "
+        "frame, without waiting for the vertical sync. The GPU times are "
+        "measured with timer queries and lag a few frames behind.");
+
+    const float maxTime = std::max(
+        *std::max_element(m_cpuFrameTimes.cbegin(), m_cpuFrameTimes.cend()),
+        *std::max_element(gpuFrameTimes.cbegin(), gpuFrameTimes.cend()));
+    ImGui::PlotLines(
+        "CPU ms",
+        m_cpuFrameTimes.data(),
+        static_cast<int>(numFrames),
+        static_cast<int>(m_cpuFrameTimesPos),
+        nullptr,
+        0.f,
+        maxTime,
+        ImVec2(0.f, 40.f));
+    ImGui::PlotLines(
+        "GPU ms",
+        gpuFrameTimes.data(),
+        static_cast<int>(numFrames),
+        static_cast<int>(m_gpuTimer.getHistoryOffset()),
+        nullptr,
+        0.f,
+        maxTime,
+        ImVec2(0.f, 40.f));
+
+    for (size_t pass = 0; pass < m_gpuTimer.getNumPasses(); ++pass)
+        ImGui::BulletText(
+            "%-10s %.3f ms",
+            m_gpuTimer.getPassName(pass),
+            m_gpuTimer.getAveragePassTime(pass));
+}
+
+void draw::Renderer::setTimeStepRange(uint64_t oldest, uint64_t latest)
+{
+    m_oldestStep = oldest;
+    m_latestStep = latest;
+
+    if (m_followLatestStep)
+        m_selectedStep = latest;
+    else
+        m_selectedStep = std::min(std::max(m_selectedStep, oldest), latest);
+}
+
 void draw::Renderer::updateFramebufferObjects(void)
 {
     // for the final rendering result
@@ -670,23 +839,287 @@ void draw::Renderer::updateFramebufferObjects(void)
                 std::move(fboTextures), attachments);
 
     }
+}
+
+/**
+ * \brief Creates the cached color mapped fracture textures of the network
+ *        case and one framebuffer object per texture layer
+ */
+void draw::Renderer::createFractureRenderTargets()
+{
+    m_fractureFbos.clear();
+    m_fractureTextures = util::texture::Texture2DArray(
+            GL_RGBA,
+            GL_RGBA,
+            0,
+            GL_FLOAT,
+            GL_LINEAR,
+            GL_CLAMP_TO_BORDER,
+            FRACTURE_TEXTURE_RESOLUTION[0],
+            FRACTURE_TEXTURE_RESOLUTION[1],
+            m_fractureNetwork.size());
+
+    for (size_t i = 0; i < m_fractureNetwork.size(); ++i)
+        m_fractureFbos.emplace_back(
+                m_fractureTextures,
+                static_cast<GLint>(i),
+                GL_COLOR_ATTACHMENT0);
+
+    m_fractureGenerations.fill(INVALID_DATA_GENERATION);
+}
+
+/**
+ * \brief Draws the color mapped data and isolines of a mesh into the
+ *        currently bound framebuffer
+ *
+ * \param idx             index of the visualization mesh
+ * \param data            scalar data values of the mesh
+ * \param updateIsolines  re-extract the isolines instead of drawing the
+ *                        geometry of the previous call
+ */
+void draw::Renderer::drawFractureData(
+        size_t idx, const fractureData_t &data, bool updateIsolines)
+{
+    const bool gpuIsolines =
+        (static_cast<int>(IsolineMode::gpu) == m_isolineMode);
+    const glm::vec3 isolineColor(
+        m_isolineColor[0], m_isolineColor[1], m_isolineColor[2]);
+
+    // color mapped data
+    {
+        TRACE_SCOPE("colormap");
+        util::GpuTimer::Scope gpuScope(
+            m_gpuTimer, static_cast<size_t>(RenderPass::colormap));
+        m_fractureShader.use();
+        m_fractureShader.setMat4("projMX", m_quadProjMx);
+        m_fractureShader.setFloat("tfMin", m_cmClipMin);
+        m_fractureShader.setFloat("tfMax", m_cmClipMax);
+
+        m_fractureShader.setBool("isolinesEnabled", gpuIsolines);
+        m_fractureShader.setFloat("isoInterval", m_isovalueInterval);
+        m_fractureShader.setFloat("isoOffset", m_cmClipMin);
+        m_fractureShader.setFloat("isoWidth", ISOLINE_WIDTH);
+        m_fractureShader.setVec3("isoColor", isolineColor);
+
+        glActiveTexture(GL_TEXTURE0);
+        m_dataTextures[idx].bind();
+        m_fractureShader.setInt("sampleTex", 0);
+
+        glActiveTexture(GL_TEXTURE1);
+        if (m_cmSelect == 0)
+            m_smoothcoolwarmMap.bind();
+        else
+            m_viridisMap.bind();
+        m_fractureShader.setInt("tfTex", 1);
+
+        m_windowQuad.draw();
+    }
+
+    // the fragment shader already drew the isolines
+    if (gpuIsolines)
+        return;
+
+    glm::mat3 pvmMx = glm::transpose(glm::mat3(
+            2.f / (data.shape()[1] - 1.f), 0.f, -1.0f,
+            0.f, 2.f / (data.shape()[0] -1.f), -1.0f,
+            0.f, 0.f, 1.f));
+
+    glClear(GL_DEPTH_BUFFER_BIT );
+    glLineWidth(ISOLINE_WIDTH);
+    m_isolineShader.use();
+    m_isolineShader.setMat3("pvmMx", pvmMx);
+    m_isolineShader.setVec4("linecolor", glm::vec4(isolineColor, 1.f));
+
+    util::geometry::LineBatch2D& isolines = accessIsolineBatch(idx);
+    if (updateIsolines)
+    {
+        TRACE_SCOPE("isolines/extract");
+        isolines.update(util::extractIsolines(
+                data, m_isovalues, m_minMaxPyramids[idx]));
+    }
+
+    TRACE_SCOPE("isolines/draw");
+    util::GpuTimer::Scope gpuScope(
+        m_gpuTimer, static_cast<size_t>(RenderPass::isolines));
+    isolines.draw();
+}
 
-    // for textures of 3D fractures
+/**
+ * \brief Starts the CPU and GPU time measurement of a frame
+ */
+void draw::Renderer::beginFrame()
+{
+    m_frameBegin = std::chrono::steady_clock::now();
+    m_gpuTimer.beginFrame();
+    m_frameCapture->poll();
+}
+
+/**
+ * \brief Shows the cached rendering result together with the menu
+ *
+ * \return EXIT_SUCCESS or EXIT_FAILURE if an OpenGL error occurred
+ */
+int draw::Renderer::presentFrame()
+{
+    if (m_captureEveryFrame)
     {
-        std::vector<util::texture::Texture2D> fboTextures;
-        fboTextures.emplace_back(
-                GL_RGBA,
-                GL_RGBA,
+        char filename[200];
+        std::snprintf(
+            filename,
+            sizeof(filename),
+            "%s_%06llu.png",
+            m_capturePrefix.c_str(),
+            static_cast<unsigned long long>(m_numCapturedFrames++));
+        m_frameCapture->capture(
+            m_framebuffer,
+            m_windowDimensions[0],
+            m_windowDimensions[1],
+            filename,
+            FIF_PNG);
+    }
+
+    // nothing is shown without a window, the frame stays in m_framebuffer
+    if (m_headless)
+        return printOpenGLError() ? EXIT_FAILURE : EXIT_SUCCESS;
+
+    // show the rendering result as window filling quad
+    {
+        util::GpuTimer::Scope gpuScope(
+            m_gpuTimer, static_cast<size_t>(RenderPass::present));
+        glViewport(0, 0, m_windowDimensions[0], m_windowDimensions[1]);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+
+        m_windowShader.use();
+        m_windowShader.setMat4("projMX", m_quadProjMx);
+
+        glActiveTexture(GL_TEXTURE0);
+        m_framebuffer.accessTextures()[0].bind();
+        m_windowShader.setInt("renderTex", 0);
+
+        m_windowQuad.draw();
+    }
+
+    {
+        TRACE_SCOPE("imgui");
+        util::GpuTimer::Scope gpuScope(
+            m_gpuTimer, static_cast<size_t>(RenderPass::imgui));
+        renderImgui();
+    }
+
+    // the CPU time of a frame excludes waiting for the vertical sync
+    m_cpuFrameTimes[m_cpuFrameTimesPos] =
+        std::chrono::duration<float, std::milli>(
+            std::chrono::steady_clock::now() - m_frameBegin).count();
+    m_cpuFrameTimesPos = (m_cpuFrameTimesPos + 1) % m_cpuFrameTimes.size();
+    m_numCpuFrameTimes =
+        std::min(m_numCpuFrameTimes + 1, m_cpuFrameTimes.size());
+
+    {
+        TRACE_SCOPE("swapBuffers");
+        glfwSwapBuffers(m_window);
+    }
+
+
+    if (printOpenGLError())
+        return EXIT_FAILURE;
+    else
+        return EXIT_SUCCESS;
+}
+
+/**
+ * \brief Samples the isovalues from the transfer function interval
+ */
+void draw::Renderer::updateIsovalues()
+{
+    m_isovalues.clear();
+    if (m_isovalueInterval <= 0.f)
+        return;
+
+    for (
+            float isovalue = m_cmClipMin;
+            isovalue < m_cmClipMax;
+            isovalue += m_isovalueInterval)
+        m_isovalues.push_back(isovalue);
+}
+
+/**
+ * \brief Returns the persistent isoline geometry of a mesh
+ *
+ * \param idx   index of the visualization mesh
+ */
+util::geometry::LineBatch2D& draw::Renderer::accessIsolineBatch(size_t idx)
+{
+    while (m_isolineBatches.size() <= idx)
+        m_isolineBatches.emplace_back(true);
+
+    return m_isolineBatches[idx];
+}
+
+/**
+ * \brief Uploads the given data into the persistent texture of a mesh
+ *
+ * \param idx   index of the visualization mesh
+ * \param data  scalar data values of the mesh
+ *
+ * The texture storage is only reallocated when the grid dimensions change,
+ * otherwise the content is replaced in place.
+ */
+void draw::Renderer::updateDataTexture(size_t idx, const fractureData_t &data)
+{
+    if (m_dataTextures.size() <= idx)
+    {
+        m_dataTextures.resize(idx + 1);
+        m_dataDimensions.resize(idx + 1);
+        m_minMaxPyramids.resize(idx + 1);
+    }
+
+    const size_t height = data.shape()[0];
+    const size_t width = data.shape()[1];
+
+    std::array<size_t, 2>& dimensions = m_dataDimensions[idx];
+    if ((dimensions[0] != height) || (dimensions[1] != width) ||
+            (0 == m_dataTextures[idx].getID()))
+    {
+        dimensions = {{ height, width }};
+        m_dataTextures[idx] = util::texture::Texture2D(
+                GL_R32F,
+                GL_RED,
                 0,
                 GL_FLOAT,
                 GL_LINEAR,
-                GL_CLAMP_TO_BORDER,
-                FRACTURE_TEXTURE_RESOLUTION[0],
-                FRACTURE_TEXTURE_RESOLUTION[1]);
-        const std::vector<GLenum> attachments { GL_COLOR_ATTACHMENT0 };
-        m_fractureFbo = util::FramebufferObject(
-                std::move(fboTextures), attachments);
+                GL_CLAMP_TO_EDGE,
+                width,
+                height);
+    }
+
+    const size_t numValues = width * height;
+    float *mapped = nullptr;
+    if (static_cast<int>(UploadMode::pixelBuffer) == m_uploadMode)
+        mapped = static_cast<float*>(
+                m_uploadRing.map(numValues * sizeof(float)));
+
+    // the content of a mapped buffer can be lost, e.g. on a mode switch,
+    // then the data is uploaded directly
+    bool uploaded = false;
+    if (nullptr != mapped)
+    {
+        std::copy(data.data(), data.data() + numValues, mapped);
+        uploaded = m_uploadRing.unmapToTexture(
+                m_dataTextures[idx], GL_RED, GL_FLOAT, width, height);
+    }
+
+    if (!uploaded)
+    {
+        m_dataTextures[idx].update(
+                GL_RED,
+                GL_FLOAT,
+                width,
+                height,
+                static_cast<void const*>(data.data()));
     }
+
+    m_minMaxPyramids[idx].build(data);
 }
 
 //-----------------------------------------------------------------------------
@@ -720,6 +1153,7 @@ void draw::Renderer::cursorPosition_cb(
 
         pThis->m_cameraPosition =
             util::polarToCartesian<glm::vec3>(polar) + pThis->m_cameraLookAt;
+        pThis->m_viewDirty = true;
     }
     else if (GLFW_PRESS == glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_MIDDLE))
     {
@@ -736,6 +1170,7 @@ void draw::Renderer::cursorPosition_cb(
                 -dx * pThis->m_cameraTranslationSpeed) * horizontal +
             static_cast<float>(
                 dy * pThis->m_cameraTranslationSpeed) * vertical;
+        pThis->m_viewDirty = true;
     }
 
     glm::vec3 right = glm::normalize(
@@ -768,6 +1203,7 @@ void draw::Renderer::scroll_cb(GLFWwindow *window, double xoffset, double yoffse
             static_cast<float>(-yoffset) *
             pThis->m_cameraZoomSpeed *
             pThis->m_cameraPosition;
+        pThis->m_viewDirty = true;
     }
 
     glm::vec3 right = glm::normalize(
@@ -793,25 +1229,55 @@ void draw::Renderer::key_cb(
     if((key == GLFW_KEY_F5) && (action == GLFW_PRESS))
         pThis->reloadShaders();
 
-    if((key == GLFW_KEY_F9) && (action == GLFW_PRESS))
+    // start recording a trace or save the recorded one
+    if((key == GLFW_KEY_F8) && (action == GLFW_PRESS))
     {
-        std::time_t t = std::time(nullptr);
-        std::tm* tm = std::localtime(&t);
-        char filename[200];
+        if (trace::isRecording())
+        {
+            trace::stop();
+
+            std::time_t t = std::time(nullptr);
+            std::tm* tm = std::localtime(&t);
+            char filename[200];
+
+            strftime(
+                    filename,
+                    sizeof(filename),
+                    "./inpreCICE-trace_%F_%H%M%S.json",
+                    tm);
+
+            trace::writeChromeTrace(filename);
+        }
+        else
+            trace::start();
+    }
 
-        strftime(
+    // the screenshot is written in the background, Ctrl+F9 captures
+    // every frame until it is pressed again
+    if((key == GLFW_KEY_F9) && (action == GLFW_PRESS))
+    {
+        if (mods & GLFW_MOD_CONTROL)
+            pThis->toggleCapture();
+        else
+        {
+            std::time_t t = std::time(nullptr);
+            std::tm* tm = std::localtime(&t);
+            char filename[200];
+
+            strftime(
+                    filename,
+                    sizeof(filename),
+                    "./screenshots/%F_%H%M%S.png",
+                    tm);
+
+            pThis->m_frameCapture->capture(
+                pThis->m_framebuffer,
+                pThis->m_windowDimensions[0],
+                pThis->m_windowDimensions[1],
                 filename,
-                sizeof(filename),
-                "./screenshots/%F_%H%M%S.png",
-                tm);
-
-        util::makeScreenshot(
-            pThis->m_framebuffer,
-            pThis->m_windowDimensions[0],
-            pThis->m_windowDimensions[1],
-            filename,
-            FIF_PNG);
-        std::cout << "Saved screenshot " << filename << std::endl;
+                FIF_PNG);
+            std::cout << "Saving screenshot " << filename << std::endl;
+        }
     }
     // chain ImGui callback
     ImGui_ImplGlfw_KeyCallback(window, key, scancode, action, mods);
@@ -835,6 +1301,7 @@ void draw::Renderer::framebufferSize_cb(
     pThis->m_windowDimensions[1] = height;
 
     pThis->updateFramebufferObjects();
+    pThis->m_viewDirty = true;
 }
 
 void draw::Renderer::error_cb(int error, const char* description)
@@ -1,7 +1,12 @@
 #pragma once
 
 #include <array>
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <limits>
+#include <memory>
+#include <string>
 #include <GL/gl3w.h>
 #include <GLFW/glfw3.h>
 
@@ -28,7 +33,43 @@ namespace draw
 
         static const std::array<size_t, 2>FRACTURE_TEXTURE_RESOLUTION;
 
+        static constexpr size_t PIXEL_BUFFER_RING_SIZE = 3;
+        static constexpr float ISOLINE_WIDTH = 2.f;
+        static constexpr uint64_t INVALID_DATA_GENERATION =
+            std::numeric_limits<uint64_t>::max();
+        // upper bound for blocking in event driven mode in seconds
+        static constexpr double EVENT_WAIT_TIMEOUT = 1.0;
+
         public:
+        /**
+         * \brief Path used for uploading the scalar data into textures
+         *
+         * synchronous: glTexSubImage2D directly from client memory
+         * pixelBuffer: through a ring of mapped pixel buffer objects
+         */
+        enum class UploadMode : int { synchronous = 0, pixelBuffer = 1 };
+
+        /**
+         * \brief Method used for drawing the isolines
+         *
+         * cpu: marching squares on the CPU, drawn as line geometry
+         * gpu: evaluated per fragment in the fracture shader
+         */
+        enum class IsolineMode : int { cpu = 0, gpu = 1 };
+
+        /**
+         * \brief Render passes whose GPU time is shown in the menu
+         */
+        enum class RenderPass : size_t
+        {
+            upload,
+            colormap,
+            isolines,
+            composite,
+            present,
+            imgui
+        };
+
         Renderer();
         Renderer(unsigned int winWidth, unsigned int winHeight);
         ~Renderer();
@@ -56,40 +97,134 @@ namespace draw
          */
         bool processEvents();
 
+        /**
+         * \brief Selects whether processEvents() blocks until an event
+         *        arrives
+         *
+         * In event driven mode, processEvents() sleeps until an input event
+         * occurs, wakeUp() is called or EVENT_WAIT_TIMEOUT expires, instead
+         * of returning immediately.
+         */
+        void setEventDriven(bool eventDriven)
+        {
+            m_eventDriven = eventDriven;
+        }
+
+        /**
+         * \brief Selects whether the renderer runs without a visible window
+         *
+         * Has to be set before initialize(). In headless mode, frames are
+         * only rendered into the framebuffer object at the window size and
+         * can be written with saveFrame(). Without a display server, the
+         * context is created with OSMesa if GLFW supports it.
+         */
+        void setHeadless(bool headless) { m_headless = headless; }
+
+        /**
+         * \brief Wakes up a blocking processEvents(), can be called from any
+         *        thread
+         */
+        static void wakeUp() { glfwPostEmptyEvent(); }
+
+        /**
+         * \brief Sets the range of time steps that can be selected in the
+         *        menu
+         *
+         * \param oldest  oldest time step that is still available
+         * \param latest  most recent time step
+         */
+        void setTimeStepRange(uint64_t oldest, uint64_t latest);
+
+        /**
+         * \brief Returns true if the latest time step shall be drawn, false
+         *        if an older time step was selected in the menu
+         */
+        bool isFollowingLatestTimeStep() const { return m_followLatestStep; }
+
+        /**
+         * \brief Returns the time step selected in the menu
+         */
+        uint64_t getSelectedTimeStep() const { return m_selectedStep; }
+
+        /**
+         * \brief Selects how scalar data is uploaded into textures
+         */
+        void setUploadMode(UploadMode mode)
+        {
+            m_uploadMode = static_cast<int>(mode);
+        }
+
         /**
          * \brief Draw call for visualization of the single fracture case
          *
-         * \param data  scalar data values
+         * \param data            scalar data values
+         * \param dataGeneration  version of the data, has to change whenever
+         *                        the data values change
+         *
+         * The data is not copied, it only has to stay valid during the call.
          *
          * \return EXIT_SUCCESS true as long as the window is still open,
          *         false when it was closed
          *
          * Draws the scalar data values into a window spanning quad using a
-         * color map and isolines.
+         * color map and isolines. If neither the data generation nor the view
+         * or visualization settings changed since the last call, only the
+         * cached result and the menu are shown again.
          */
-        using fractureData_t = boost::multi_array<double, 2>;
-        int drawSingleFracture(const fractureData_t &data);
+        using fractureData_t = boost::multi_array<float, 2>;
+        int drawSingleFracture(
+                const fractureData_t &data, uint64_t dataGeneration);
 
         /**
          * \brief Draw call for visualization of the fracture network case
          *
-         * \param dataArray  array of scalar data values for the 9 fractures
+         * \param dataArray       array of scalar data values for the 9
+         *                        fractures
+         * \param dataGeneration  version of the data, has to change whenever
+         *                        the data values change
+         *
+         * The data is not copied, it only has to stay valid during the call.
          *
          * \return EXIT_SUCCESS true as long as the window is still open,
          *         false when it was closed
          *
          * Draws the scalar data values as texture onto 3D planes representing
-         * the fracture network.
+         * the fracture network. If neither the data generation nor the view
+         * or visualization settings changed since the last call, only the
+         * cached result and the menu are shown again.
          */
         using fractureDataArray_t =
                 std::array<std::reference_wrapper<const fractureData_t>, 9>;
-        int drawFractureNetwork(const fractureDataArray_t &dataArray);
+        int drawFractureNetwork(
+                const fractureDataArray_t &dataArray, uint64_t dataGeneration);
+
+        /**
+         * \brief Writes the last rendered frame without the menu to a PNG
+         *        file
+         *
+         * \return EXIT_SUCCESS or EXIT_FAILURE if the renderer is not
+         *         initialized
+         *
+         * The file is written asynchronously by a writer thread, in headless
+         * mode drawing waits for the writer instead of dropping frames.
+         */
+        int saveFrame(const std::string &file);
+
+        /**
+         * \brief Waits until all saved and captured frames are written,
+         *        later frames are dropped
+         *
+         * \return EXIT_SUCCESS or EXIT_FAILURE if a frame was not written
+         */
+        int finishFrameCapture();
 
         private:
         GLFWwindow* m_window;
         std::array<unsigned int, 2> m_windowDimensions;
 
         bool m_isInitialized;
+        bool m_eventDriven;
+        bool m_headless;
 
         // clipping values for color mapping
         float m_cmClipMin;
@@ -100,6 +235,25 @@ namespace draw
         // interval between isolines
         float m_isovalueInterval;
         std::array<float, 3> m_isolineColor;
+        std::vector<float> m_isovalues;
+        int m_isolineMode;
+
+        // change tracking for skipping unchanged frames
+        uint64_t m_renderedDataGeneration;
+        bool m_viewDirty;       //!< camera or window changed
+        bool m_fracturesDirty;  //!< color mapping or isoline settings changed
+        bool m_isolinesDirty;   //!< isoline geometry has to be re-extracted
+
+        // persistent data textures, their dimensions and the min-max
+        // pyramids for the isoline extraction, one per visualization mesh
+        std::vector<util::texture::Texture2D> m_dataTextures;
+        std::vector<std::array<size_t, 2>> m_dataDimensions;
+        std::vector<util::MinMaxPyramid<float>> m_minMaxPyramids;
+        int m_uploadMode;
+        util::texture::PixelUnpackBufferRing m_uploadRing;
+
+        // persistent isoline geometry, one batch per visualization mesh
+        std::vector<util::geometry::LineBatch2D> m_isolineBatches;
 
         // fracture network geometry
         std::array<util::geometry::Quad, 9> m_fractureNetwork;
@@ -118,7 +272,10 @@ namespace draw
         glm::mat4 m_3dViewMx;
         glm::mat4 m_3dProjMx;
 
-        util::FramebufferObject m_fractureFbo;
+        // cached color mapped fracture textures, one layer per fracture
+        util::texture::Texture2DArray m_fractureTextures;
+        std::vector<util::FramebufferObject> m_fractureFbos;
+        std::array<uint64_t, 9> m_fractureGenerations;
 
         Shader m_planeShader;
         Shader m_frameShader;
@@ -135,8 +292,27 @@ namespace draw
         util::geometry::Quad m_windowQuad;
         glm::mat4 m_quadProjMx;
 
+        // browsing of recent time steps
+        uint64_t m_oldestStep;
+        uint64_t m_latestStep;
+        uint64_t m_selectedStep;
+        bool m_followLatestStep;
+
         bool m_showDemoWindow;
 
+        // CPU and GPU frame times for the timing breakdown in the menu
+        util::GpuTimer m_gpuTimer;
+        std::chrono::steady_clock::time_point m_frameBegin;
+        std::array<float, util::GpuTimer::HISTORY_LENGTH> m_cpuFrameTimes;
+        size_t m_cpuFrameTimesPos;
+        size_t m_numCpuFrameTimes;
+
+        // asynchronous screenshots and continuous capture of every frame
+        std::unique_ptr<util::FrameCapture> m_frameCapture;
+        bool m_captureEveryFrame;
+        std::string m_capturePrefix;
+        uint64_t m_numCapturedFrames;
+
         //---------------------------------------------------------------------
         // helper functions
         //---------------------------------------------------------------------
@@ -150,12 +326,23 @@ namespace draw
         void processInput();
 
         void reloadShaders();
+        void toggleCapture();
 
         void createHelpMarker(const std::string description);
 
         void renderImgui(void);
+        void renderTimingBreakdown();
 
         void updateFramebufferObjects();
+        void createFractureRenderTargets();
+
+        void beginFrame();
+        void drawFractureData(
+                size_t idx, const fractureData_t &data, bool updateIsolines);
+        int presentFrame();
+        void updateIsovalues();
+        void updateDataTexture(size_t idx, const fractureData_t &data);
+        util::geometry::LineBatch2D& accessIsolineBatch(size_t idx);
 
         //---------------------------------------------------------------------
         // glfw callback functions
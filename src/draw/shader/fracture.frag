@@ -9,6 +9,12 @@ uniform sampler2D tfTex;
 uniform float tfMin;
 uniform float tfMax;
 
+uniform bool isolinesEnabled;   //!< draw isolines in this pass
+uniform float isoInterval;      //!< distance between neighbouring isovalues
+uniform float isoOffset;        //!< lowest isovalue
+uniform float isoWidth;         //!< line width in pixels
+uniform vec3 isoColor;
+
 void main()
 {
     float value = texture(sampleTex, vTexCoord).r;
@@ -18,4 +24,17 @@ void main()
             vec2((value - tfMin) / (tfMax - tfMin), 0.5f)).rgb,
             1.f);
 
+    if (isolinesEnabled)
+    {
+        // distance to the nearest isovalue in units of the isovalue interval,
+        // divided by its screen space derivative to get a constant width
+        // (derivatives have to be computed in uniform control flow)
+        float level = (value - isoOffset) / isoInterval;
+        float levelWidth = max(fwidth(level), 1e-6f);
+        float dist = abs(fract(level - 0.5f) - 0.5f) / levelWidth;
+        float coverage = 1.f - clamp(dist - 0.5f * isoWidth + 0.5f, 0.f, 1.f);
+
+        if ((value >= isoOffset) && (value <= tfMax))
+            fragColor.rgb = mix(fragColor.rgb, isoColor, coverage);
+    }
 }
@@ -4,13 +4,14 @@ layout(location = 0) out vec4 fragColor;
 in vec2 vTexCoord;
 in vec3 vNormal;
 
-uniform sampler2D fractureTex;
+uniform sampler2DArray fractureTex;
+uniform int fractureLayer;
 
 uniform vec3 lightDir;
 
 void main()
 {
-    vec4 textureColor = texture(fractureTex, vTexCoord);
+    vec4 textureColor = texture(fractureTex, vec3(vTexCoord, fractureLayer));
 
     vec3 normal = normalize(vNormal);
 
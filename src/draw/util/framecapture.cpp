@@ -0,0 +1,255 @@
+#include "framecapture.hpp"
+
+#include <iostream>
+#include <utility>
+
+#include "util.hpp"
+#include "trace/trace.hpp"
+
+constexpr size_t util::FrameCapture::NUM_BUFFERS;
+constexpr size_t util::FrameCapture::QUEUE_CAPACITY;
+
+namespace
+{
+    // timeout of a single wait for a readback in nanoseconds
+    constexpr GLuint64 READBACK_WAIT_TIMEOUT = 100000000;
+}
+
+//-----------------------------------------------------------------------------
+// FrameCapture
+//-----------------------------------------------------------------------------
+util::FrameCapture::FrameCapture() :
+    m_readbacks(),
+    m_oldest(0),
+    m_numPending(0),
+    m_waitForWriter(false),
+    m_queue(QUEUE_CAPACITY),
+    m_queueHead(0),
+    m_queueSize(0),
+    m_stop(false),
+    m_numDroppedFrames(0),
+    m_numFailedFrames(0)
+{
+    for (Readback &readback : m_readbacks)
+    {
+        glGenBuffers(1, &readback.buffer);
+        readback.fence = nullptr;
+    }
+
+    m_writerThread = std::thread(&FrameCapture::runWriter, this);
+}
+
+util::FrameCapture::~FrameCapture()
+{
+    close();
+
+    for (Readback &readback : m_readbacks)
+        glDeleteBuffers(1, &readback.buffer);
+}
+
+/**
+ * \brief Starts reading the first color attachment of a framebuffer object
+ * \param fbo            framebuffer object holding the frame
+ * \param width          horizontal size of the frame in pixel
+ * \param height         vertical size of the frame in pixel
+ * \param file           name and path of the image file
+ * \param type           FreeImage image type (FIF_PNG, FIF_BMP, ...)
+ *
+ * Only waits for a previous readback if all buffers of the ring are still
+ * in flight.
+ */
+void util::FrameCapture::capture(
+    const FramebufferObject &fbo,
+    unsigned int width,
+    unsigned int height,
+    const std::string &file,
+    FREE_IMAGE_FORMAT type)
+{
+    TRACE_SCOPE("FrameCapture::capture");
+    if (NUM_BUFFERS == m_numPending)
+        finishReadback(true);
+
+    Readback &readback =
+        m_readbacks[(m_oldest + m_numPending) % NUM_BUFFERS];
+    readback.width = width;
+    readback.height = height;
+    readback.file = file;
+    readback.type = type;
+
+    // with a bound pack buffer glReadPixels returns before the transfer
+    // has completed, the previous content of the buffer is orphaned
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+    glBufferData(
+        GL_PIXEL_PACK_BUFFER, 3 * width * height, nullptr, GL_STREAM_READ);
+
+    fbo.bindRead(0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_BGR, GL_UNSIGNED_BYTE, nullptr);
+    readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    ++m_numPending;
+}
+
+void util::FrameCapture::poll()
+{
+    while ((m_numPending > 0) && finishReadback(false))
+        ;
+}
+
+void util::FrameCapture::close()
+{
+    while (m_numPending > 0)
+        finishReadback(true);
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_stop = true;
+    }
+    m_queueCondition.notify_one();
+    m_spaceCondition.notify_all();
+
+    if (m_writerThread.joinable())
+    {
+        m_writerThread.join();
+
+        if (m_numDroppedFrames > 0)
+            std::cerr << "Warning: " << m_numDroppedFrames << " captured "
+                "frames were not written as writing them was too slow!"
+                << std::endl;
+    }
+}
+
+/**
+ * \brief Converts the oldest pending readback into an image and queues it
+ *        for writing
+ * \param wait           wait until the transfer has completed
+ *
+ * \return true if the readback was finished, false if it is still pending
+ */
+bool util::FrameCapture::finishReadback(bool wait)
+{
+    Readback &readback = m_readbacks[m_oldest];
+
+    // the flush ensures that the fence is signaled eventually, even
+    // without a buffer swap
+    GLenum status = GL_TIMEOUT_EXPIRED;
+    do
+    {
+        status = glClientWaitSync(
+            readback.fence,
+            GL_SYNC_FLUSH_COMMANDS_BIT,
+            wait ? READBACK_WAIT_TIMEOUT : 0);
+    } while (wait && (GL_TIMEOUT_EXPIRED == status));
+
+    if (GL_TIMEOUT_EXPIRED == status)
+        return false;
+
+    glDeleteSync(readback.fence);
+    readback.fence = nullptr;
+    m_oldest = (m_oldest + 1) % NUM_BUFFERS;
+    --m_numPending;
+
+    if (GL_WAIT_FAILED == status)
+    {
+        std::cerr << "Error: Reading the pixels of " << readback.file
+            << " failed!" << std::endl;
+        ++m_numFailedFrames;
+        return true;
+    }
+
+    TRACE_SCOPE("FrameCapture::convert");
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+    void* pixels = glMapBufferRange(
+        GL_PIXEL_PACK_BUFFER,
+        0,
+        3 * readback.width * readback.height,
+        GL_MAP_READ_BIT);
+    FIBITMAP* bitmap = nullptr;
+    if (nullptr != pixels)
+    {
+        bitmap = FreeImage_ConvertFromRawBits(
+            static_cast<GLubyte*>(pixels),
+            readback.width,
+            readback.height,
+            3 * readback.width,
+            24,
+            0x0000FF,
+            0x00FF00,
+            0xFF0000,
+            false);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (nullptr == bitmap)
+    {
+        std::cerr << "Error: Could not convert the pixels of "
+            << readback.file << "!" << std::endl;
+        ++m_numFailedFrames;
+        return true;
+    }
+
+    push({bitmap, readback.file, readback.type});
+    return true;
+}
+
+void util::FrameCapture::push(Image &&image)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_queueMutex);
+        if (m_waitForWriter)
+            m_spaceCondition.wait(
+                lock,
+                [this](){ return m_stop || (m_queueSize < m_queue.size()); });
+
+        if (!m_stop && (m_queueSize < m_queue.size()))
+        {
+            m_queue[(m_queueHead + m_queueSize) % m_queue.size()] =
+                std::move(image);
+            ++m_queueSize;
+            image.bitmap = nullptr;
+        }
+    }
+
+    if (nullptr != image.bitmap)
+    {
+        FreeImage_Unload(image.bitmap);
+        ++m_numDroppedFrames;
+        return;
+    }
+
+    m_queueCondition.notify_one();
+}
+
+void util::FrameCapture::runWriter()
+{
+    TRACE_THREAD_NAME("frame capture");
+    while (true)
+    {
+        Image image;
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_queueCondition.wait(
+                lock, [this](){ return m_stop || (m_queueSize > 0); });
+            if (0 == m_queueSize)
+                return;
+
+            image = std::move(m_queue[m_queueHead]);
+            m_queueHead = (m_queueHead + 1) % m_queue.size();
+            --m_queueSize;
+        }
+        m_spaceCondition.notify_one();
+
+        TRACE_SCOPE("FrameCapture::write");
+        if (!FreeImage_Save(image.type, image.bitmap, image.file.c_str(), 0))
+        {
+            std::cerr << "Error: Could not write image " << image.file
+                << std::endl;
+            ++m_numFailedFrames;
+        }
+        FreeImage_Unload(image.bitmap);
+    }
+}
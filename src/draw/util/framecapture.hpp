@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <GL/gl3w.h>
+#include <FreeImage.h>
+
+namespace util
+{
+    class FramebufferObject;
+
+    /**
+     * \brief Writes framebuffer contents to image files without stalling
+     *        the render thread
+     *
+     * The pixels are read into a ring of pixel pack buffers and a fence
+     * tells when the transfer has completed. poll() converts completed
+     * frames and hands them through a bounded queue to a writer thread,
+     * which encodes and writes the image files. If the writer falls
+     * behind, new frames are dropped, unless setWaitForWriter(true) lets
+     * the render thread wait instead.
+     *
+     * Has to be created and destroyed while the OpenGL context is current.
+     */
+    class FrameCapture
+    {
+        public:
+        static constexpr size_t NUM_BUFFERS = 3;
+        static constexpr size_t QUEUE_CAPACITY = 8;
+
+        FrameCapture();
+        FrameCapture(const FrameCapture& other) = delete;
+        FrameCapture& operator=(const FrameCapture& other) = delete;
+        ~FrameCapture();
+
+        /**
+         * \brief Selects whether frames are dropped or the render thread
+         *        waits while the queue of the writer is full
+         */
+        void setWaitForWriter(bool wait) { m_waitForWriter = wait; }
+
+        void capture(
+            const FramebufferObject &fbo,
+            unsigned int width,
+            unsigned int height,
+            const std::string &file,
+            FREE_IMAGE_FORMAT type);
+
+        /**
+         * \brief Hands all completed readbacks to the writer without
+         *        waiting for pending ones, has to be called regularly
+         */
+        void poll();
+
+        /**
+         * \brief Writes all captured frames and stops the writer thread,
+         *        later captures are dropped
+         */
+        void close();
+
+        size_t getNumDroppedFrames() const { return m_numDroppedFrames; }
+        size_t getNumFailedFrames() const { return m_numFailedFrames; }
+
+        private:
+        struct Readback
+        {
+            GLuint buffer;
+            GLsync fence;
+            unsigned int width;
+            unsigned int height;
+            std::string file;
+            FREE_IMAGE_FORMAT type;
+        };
+        struct Image
+        {
+            FIBITMAP* bitmap{nullptr};
+            std::string file;
+            FREE_IMAGE_FORMAT type;
+        };
+
+        // ring of pixel pack buffers, the pending readbacks start at
+        // m_oldest
+        std::array<Readback, NUM_BUFFERS> m_readbacks;
+        size_t m_oldest;
+        size_t m_numPending;
+        bool m_waitForWriter;
+
+        // ring of queued images
+        std::vector<Image> m_queue;
+        size_t m_queueHead;
+        size_t m_queueSize;
+        bool m_stop;
+        std::mutex m_queueMutex;
+        std::condition_variable m_queueCondition;
+        std::condition_variable m_spaceCondition;
+        std::atomic<size_t> m_numDroppedFrames;
+        std::atomic<size_t> m_numFailedFrames;
+
+        std::thread m_writerThread;
+
+        bool finishReadback(bool wait);
+        void push(Image &&image);
+        void runWriter();
+    };
+}
@@ -2,6 +2,7 @@
 #include "geometry.hpp"
 
 #include <array>
+#include <algorithm>
 
 #include <GL/gl3w.h>
 
@@ -526,4 +527,117 @@ void util::geometry::Line2D::draw() const
     this->unbind();
 }
 
+//-----------------------------------------------------------------------------
+// LineBatch2D
+//-----------------------------------------------------------------------------
+util::geometry::LineBatch2D::LineBatch2D(bool oglAvailable) :
+    m_vertexBuffer(0),
+    m_capacity(0),
+    m_numVertices(0)
+{
+    if (false == oglAvailable)
+    {
+        m_vertexArrayObject = 0;
+        return;
+    }
+
+    // create buffers
+    glGenVertexArrays(1, &m_vertexArrayObject);
+    glGenBuffers(1, &m_vertexBuffer);
+
+    this->bind();
+
+    // vertex coordinates
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+    glVertexAttribPointer(
+        0,
+        2,
+        GL_FLOAT,
+        GL_FALSE,
+        2 * sizeof(float),
+        (void*) 0);
+    glEnableVertexAttribArray(0);
 
+    this->unbind();
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+util::geometry::LineBatch2D::LineBatch2D(
+        util::geometry::LineBatch2D&& other) :
+    Shape(std::move(other)),
+    m_vertexBuffer(other.m_vertexBuffer),
+    m_capacity(other.m_capacity),
+    m_numVertices(other.m_numVertices)
+{
+    other.m_vertexBuffer = 0;
+    other.m_capacity = 0;
+    other.m_numVertices = 0;
+}
+
+util::geometry::LineBatch2D& util::geometry::LineBatch2D::operator=(
+        util::geometry::LineBatch2D&& other)
+{
+    Shape::operator=(std::move(other));
+
+    if (0 != m_vertexBuffer)
+        glDeleteBuffers(1, &m_vertexBuffer);
+    m_vertexBuffer = other.m_vertexBuffer;
+    m_capacity = other.m_capacity;
+    m_numVertices = other.m_numVertices;
+    other.m_vertexBuffer = 0;
+    other.m_capacity = 0;
+    other.m_numVertices = 0;
+
+    return *this;
+}
+
+util::geometry::LineBatch2D::~LineBatch2D()
+{
+    if (0 != m_vertexBuffer)
+        glDeleteBuffers(1, &m_vertexBuffer);
+}
+
+/**
+ * \brief Replaces the line segments of the batch
+ *
+ * \param vertices  flat array of segment end points (x1, y1, x2, y2, ...)
+ */
+void util::geometry::LineBatch2D::update(const std::vector<float> &vertices)
+{
+    if (0 == m_vertexBuffer)
+        return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+
+    // grow geometrically so that slowly increasing line counts do not
+    // trigger a reallocation each frame, otherwise the storage is reused
+    if (vertices.size() > m_capacity)
+    {
+        m_capacity = std::max(vertices.size(), 2 * m_capacity);
+        glBufferData(
+            GL_ARRAY_BUFFER,
+            m_capacity * sizeof(float),
+            nullptr,
+            GL_DYNAMIC_DRAW);
+    }
+    if (!vertices.empty())
+        glBufferSubData(
+            GL_ARRAY_BUFFER,
+            0,
+            vertices.size() * sizeof(float),
+            vertices.data());
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_numVertices = static_cast<GLsizei>(vertices.size() / 2);
+}
+
+void util::geometry::LineBatch2D::draw() const
+{
+    if (0 == m_numVertices)
+        return;
+
+    this->bind();
+    glDrawArrays(GL_LINES, 0, m_numVertices);
+    this->unbind();
+}
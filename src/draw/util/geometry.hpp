@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <vector>
 #include <GL/gl3w.h>
 
 namespace util
@@ -93,5 +94,30 @@ namespace util
             void draw() const;
         };
 
+        /**
+         * \brief Set of 2D line segments drawn with a single draw call
+         *
+         * The vertex buffer is kept alive between updates and only grows
+         * when more vertices are uploaded than fit into it.
+         */
+        class LineBatch2D : Shape
+        {
+            public:
+            LineBatch2D(bool oglAvailable);
+            LineBatch2D(const LineBatch2D& other) = delete;
+            LineBatch2D& operator=(const LineBatch2D& other) = delete;
+            LineBatch2D(LineBatch2D&& other);
+            LineBatch2D& operator=(LineBatch2D&& other);
+            ~LineBatch2D();
+
+            void update(const std::vector<float> &vertices);
+            void draw() const;
+
+            private:
+            GLuint m_vertexBuffer;
+            size_t m_capacity;      //!< size of the vertex buffer in floats
+            GLsizei m_numVertices;
+        };
+
     }
 }
@@ -0,0 +1,218 @@
+#include "gputimer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <utility>
+
+#include "trace/trace.hpp"
+
+constexpr size_t util::GpuTimer::NUM_FRAMES;
+constexpr size_t util::GpuTimer::HISTORY_LENGTH;
+
+//-----------------------------------------------------------------------------
+// GpuTimer
+//-----------------------------------------------------------------------------
+util::GpuTimer::GpuTimer() :
+    m_passNames(),
+    m_frames(),
+    m_current(0),
+    m_openQueries(),
+    m_passTimes(),
+    m_frameTimes(),
+    m_historyPos(0),
+    m_numSamples(0)
+{
+    m_frameTimes.fill(0.f);
+}
+
+/**
+ * \brief Creates a timer for the given render passes
+ * \param passNames      names of the passes, a pass is identified by its
+ *                       index in this list
+ *
+ * The query objects are created on demand while the first frames are
+ * recorded.
+ */
+util::GpuTimer::GpuTimer(const std::vector<const char*> &passNames) :
+    GpuTimer()
+{
+    m_passNames = passNames;
+    m_openQueries.assign(m_passNames.size(), 0);
+
+    std::array<float, HISTORY_LENGTH> noTimes;
+    noTimes.fill(0.f);
+    m_passTimes.assign(m_passNames.size(), noTimes);
+}
+
+util::GpuTimer::GpuTimer(util::GpuTimer&& other) :
+    m_passNames(std::move(other.m_passNames)),
+    m_frames(std::move(other.m_frames)),
+    m_current(other.m_current),
+    m_openQueries(std::move(other.m_openQueries)),
+    m_passTimes(std::move(other.m_passTimes)),
+    m_frameTimes(other.m_frameTimes),
+    m_historyPos(other.m_historyPos),
+    m_numSamples(other.m_numSamples)
+{
+    for (Frame &frame : other.m_frames)
+        frame.queries.clear();
+}
+
+util::GpuTimer& util::GpuTimer::operator=(util::GpuTimer&& other)
+{
+    deleteQueries();
+
+    m_passNames = std::move(other.m_passNames);
+    m_frames = std::move(other.m_frames);
+    m_current = other.m_current;
+    m_openQueries = std::move(other.m_openQueries);
+    m_passTimes = std::move(other.m_passTimes);
+    m_frameTimes = other.m_frameTimes;
+    m_historyPos = other.m_historyPos;
+    m_numSamples = other.m_numSamples;
+    for (Frame &frame : other.m_frames)
+        frame.queries.clear();
+
+    return *this;
+}
+
+util::GpuTimer::~GpuTimer()
+{
+    deleteQueries();
+}
+
+void util::GpuTimer::deleteQueries()
+{
+    for (Frame &frame : m_frames)
+    {
+        if (!frame.queries.empty())
+            glDeleteQueries(
+                static_cast<GLsizei>(frame.queries.size()),
+                frame.queries.data());
+        frame.queries.clear();
+    }
+}
+
+void util::GpuTimer::beginFrame()
+{
+    if (m_passNames.empty())
+        return;
+
+    // the oldest frame of the ring is reused for the new frame
+    m_current = (m_current + 1) % NUM_FRAMES;
+    Frame &frame = m_frames[m_current];
+    if (!frame.measurements.empty())
+        readBack(frame);
+
+    frame.numUsedQueries = 0;
+    frame.measurements.clear();
+}
+
+/**
+ * \brief Reads the results of a frame if the GPU has finished it
+ */
+void util::GpuTimer::readBack(Frame &frame)
+{
+    // the queries complete in order, so all results are there if the last
+    // one is available
+    GLint available = 0;
+    glGetQueryObjectiv(
+        frame.queries[frame.numUsedQueries - 1],
+        GL_QUERY_RESULT_AVAILABLE,
+        &available);
+    if (!available)
+        return;
+
+    std::vector<GLuint64> timestamps(frame.numUsedQueries);
+    for (size_t i = 0; i < frame.numUsedQueries; ++i)
+        glGetQueryObjectui64v(
+            frame.queries[i], GL_QUERY_RESULT, &timestamps[i]);
+
+    std::vector<float> passTimes(m_passNames.size(), 0.f);
+    for (const Measurement &measurement : frame.measurements)
+        passTimes[measurement.pass] += 1e-6f * static_cast<float>(
+            timestamps[measurement.endQuery] -
+            timestamps[measurement.beginQuery]);
+
+    for (size_t pass = 0; pass < m_passNames.size(); ++pass)
+        m_passTimes[pass][m_historyPos] = passTimes[pass];
+    m_frameTimes[m_historyPos] =
+        std::accumulate(passTimes.cbegin(), passTimes.cend(), 0.f);
+    m_historyPos = (m_historyPos + 1) % HISTORY_LENGTH;
+    m_numSamples = std::min(m_numSamples + 1, HISTORY_LENGTH);
+
+    if (!trace::isRecording())
+        return;
+
+    // map the GPU clock to the CPU clock of the trace, the current GPU
+    // time is taken when all previous commands have reached the GPU
+    GLint64 gpuNow = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+    const trace::clock_t::time_point cpuNow = trace::clock_t::now();
+    auto toCpuTime = [&](GLuint64 timestamp) {
+        const std::chrono::nanoseconds age(
+            gpuNow - static_cast<GLint64>(timestamp));
+        return cpuNow -
+            std::chrono::duration_cast<trace::clock_t::duration>(age);
+    };
+
+    for (const Measurement &measurement : frame.measurements)
+        trace::addTrackEvent(
+            "GPU",
+            m_passNames[measurement.pass],
+            toCpuTime(timestamps[measurement.beginQuery]),
+            toCpuTime(timestamps[measurement.endQuery]));
+}
+
+GLuint util::GpuTimer::acquireQuery(size_t &index)
+{
+    Frame &frame = m_frames[m_current];
+    if (frame.numUsedQueries == frame.queries.size())
+    {
+        frame.queries.push_back(0);
+        glGenQueries(1, &frame.queries.back());
+    }
+
+    index = frame.numUsedQueries++;
+    return frame.queries[index];
+}
+
+void util::GpuTimer::begin(size_t pass)
+{
+    if (pass >= m_passNames.size())
+        return;
+
+    glQueryCounter(acquireQuery(m_openQueries[pass]), GL_TIMESTAMP);
+}
+
+void util::GpuTimer::end(size_t pass)
+{
+    if (pass >= m_passNames.size())
+        return;
+
+    size_t index = 0;
+    glQueryCounter(acquireQuery(index), GL_TIMESTAMP);
+    m_frames[m_current].measurements.push_back(
+        {pass, m_openQueries[pass], index});
+}
+
+float util::GpuTimer::getAveragePassTime(size_t pass) const
+{
+    if (0 == m_numSamples)
+        return 0.f;
+
+    // slots that were not filled yet are zero
+    const std::array<float, HISTORY_LENGTH> &times = m_passTimes[pass];
+    return std::accumulate(times.cbegin(), times.cend(), 0.f) /
+        static_cast<float>(m_numSamples);
+}
+
+float util::GpuTimer::getAverageFrameTime() const
+{
+    if (0 == m_numSamples)
+        return 0.f;
+
+    return std::accumulate(m_frameTimes.cbegin(), m_frameTimes.cend(), 0.f) /
+        static_cast<float>(m_numSamples);
+}
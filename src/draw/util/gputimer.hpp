@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <GL/gl3w.h>
+
+namespace util
+{
+    /**
+     * \brief Measures the GPU time of render passes without stalling
+     *
+     * Each pass is enclosed by two GL_TIMESTAMP queries. The queries of a
+     * frame are only read back NUM_FRAMES - 1 frames later, when the GPU has
+     * usually finished them. Frames whose results are still not available
+     * are skipped instead of waiting for them. A pass may be measured
+     * several times per frame, e.g. once per fracture, the times add up.
+     *
+     * While a trace is recorded, the measured passes are also added to the
+     * "GPU" track of the trace. Pass names have to be string literals or
+     * otherwise outlive the trace.
+     */
+    class GpuTimer
+    {
+        public:
+        static constexpr size_t NUM_FRAMES = 4;
+        //! number of frames kept for averages and plots
+        static constexpr size_t HISTORY_LENGTH = 120;
+
+        /**
+         * \brief Measures a pass for its own lifetime
+         */
+        class Scope
+        {
+            public:
+            Scope(GpuTimer &timer, size_t pass) :
+                m_timer(timer), m_pass(pass)
+            {
+                m_timer.begin(m_pass);
+            }
+            Scope(const Scope& other) = delete;
+            Scope& operator=(const Scope& other) = delete;
+            ~Scope() { m_timer.end(m_pass); }
+
+            private:
+            GpuTimer &m_timer;
+            size_t m_pass;
+        };
+
+        GpuTimer();
+        GpuTimer(const std::vector<const char*> &passNames);
+        GpuTimer(const GpuTimer& other) = delete;
+        GpuTimer(GpuTimer&& other);
+        GpuTimer& operator=(const GpuTimer& other) = delete;
+        GpuTimer& operator=(GpuTimer&& other);
+        ~GpuTimer();
+
+        /**
+         * \brief Reads back the oldest frame of the ring and starts
+         *        recording the queries of a new frame
+         */
+        void beginFrame();
+
+        void begin(size_t pass);
+        void end(size_t pass);
+
+        size_t getNumPasses() const { return m_passNames.size(); }
+        const char* getPassName(size_t pass) const
+        {
+            return m_passNames[pass];
+        }
+
+        /**
+         * \brief Average GPU time of a pass over the measured frames of the
+         *        history in ms
+         */
+        float getAveragePassTime(size_t pass) const;
+
+        /**
+         * \brief Average GPU time of a frame over the measured frames of
+         *        the history in ms
+         */
+        float getAverageFrameTime() const;
+
+        /**
+         * \brief Ring of the GPU times of the last frames in ms, the oldest
+         *        frame is at getHistoryOffset()
+         */
+        const std::array<float, HISTORY_LENGTH>& getFrameTimes() const
+        {
+            return m_frameTimes;
+        }
+        size_t getHistoryOffset() const { return m_historyPos; }
+
+        private:
+        struct Measurement
+        {
+            size_t pass;
+            size_t beginQuery;
+            size_t endQuery;
+        };
+        struct Frame
+        {
+            std::vector<GLuint> queries;
+            size_t numUsedQueries{0};
+            std::vector<Measurement> measurements;
+        };
+
+        std::vector<const char*> m_passNames;
+        std::array<Frame, NUM_FRAMES> m_frames;
+        size_t m_current;
+        std::vector<size_t> m_openQueries;  //!< begin query of each pass
+
+        //! per pass and frame GPU times in ms, rings of HISTORY_LENGTH
+        std::vector<std::array<float, HISTORY_LENGTH>> m_passTimes;
+        std::array<float, HISTORY_LENGTH> m_frameTimes;
+        size_t m_historyPos;
+        size_t m_numSamples;  //!< filled slots of the history rings
+
+        GLuint acquireQuery(size_t &index);
+        void readBack(Frame &frame);
+        void deleteQueries();
+    };
+}
@@ -120,6 +120,42 @@ void util::texture::Texture2D::unbind() const
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
+/**
+ * \brief Overwrites the texture content without reallocating its storage
+ * \param format         format of the data: GL_RGB,...
+ * \param type           data type: GL_UNSIGNED_BYTE, GL_FLOAT,...
+ * \param width          horizontal resolution of the data
+ * \param height         vertical resolution of the data
+ * \param data           array containing the new texture data
+ * \param level          level of detail number: 0 for base level
+ *
+ * The given region must not exceed the size the texture was created with.
+ */
+void util::texture::Texture2D::update(
+    GLenum format,
+    GLenum type,
+    GLsizei width,
+    GLsizei height,
+    const GLvoid * data,
+    GLint level)
+{
+    this->bind();
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(
+        GL_TEXTURE_2D,
+        level,
+        0,
+        0,
+        width,
+        height,
+        format,
+        type,
+        data);
+
+    this->unbind();
+}
+
 //-----------------------------------------------------------------------------
 util::texture::Texture3D::Texture3D ()
 {
@@ -207,6 +243,245 @@ void util::texture::Texture3D::unbind() const
 {
     glBindTexture(GL_TEXTURE_3D, 0);
 }
+//-----------------------------------------------------------------------------
+util::texture::Texture2DArray::Texture2DArray ()
+{
+}
+
+/**
+ * \brief Creates an array of 2D textures whose layers can be used as
+ *        individual render targets
+ * \param internalFormat internal format of the texture
+ * \param format         format of the data: GL_RGB,...
+ * \param level          level of detail number: 0 for base level
+ * \param type           data type: GL_UNSIGNED_BYTE, GL_FLOAT,...
+ * \param filter         texture filter: GL_LINEAR or GL_NEAREST
+ * \param wrap           texture wrap: GL_CLAMP_TO_EDGE, ...
+ * \param width          horizontal resolution
+ * \param height         vertical resolution
+ * \param layers         number of layers
+ * \param data           array containing data for initializing the texture
+ */
+util::texture::Texture2DArray::Texture2DArray(
+    GLenum internalFormat,
+    GLenum format,
+    GLint level,
+    GLenum type,
+    GLint filter,
+    GLint wrap,
+    GLsizei width,
+    GLsizei height,
+    GLsizei layers,
+    const GLvoid * data,
+    const std::array<float, 4> &borderColor)
+{
+    glGenTextures(1, &m_ID);
+
+    this->bind();
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage3D(
+        GL_TEXTURE_2D_ARRAY,
+        level,
+        internalFormat,
+        width,
+        height,
+        layers,
+        0,
+        format,
+        type,
+        data);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, wrap);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, wrap);
+    glTexParameterfv(
+        GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor.data());
+
+    this->unbind();
+}
+
+util::texture::Texture2DArray::Texture2DArray(
+        util::texture::Texture2DArray&& other) :
+    Texture(std::move(other))
+{
+}
+
+util::texture::Texture2DArray& util::texture::Texture2DArray::operator=(
+        util::texture::Texture2DArray&& other)
+{
+    Texture::operator=(std::move(other));
+
+    return *this;
+}
+
+util::texture::Texture2DArray::~Texture2DArray()
+{
+}
+
+void util::texture::Texture2DArray::bind() const
+{
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_ID);
+}
+
+void util::texture::Texture2DArray::unbind() const
+{
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+//-----------------------------------------------------------------------------
+// upload helper class implementations
+//-----------------------------------------------------------------------------
+util::texture::PixelUnpackBufferRing::PixelUnpackBufferRing() :
+    m_IDs(0),
+    m_fences(0),
+    m_capacities(0),
+    m_current(0)
+{
+}
+
+/**
+ * \brief Creates a ring of pixel unpack buffers
+ * \param numBuffers     number of buffers in the ring
+ */
+util::texture::PixelUnpackBufferRing::PixelUnpackBufferRing(
+        size_t numBuffers) :
+    m_IDs(numBuffers, 0),
+    m_fences(numBuffers, nullptr),
+    m_capacities(numBuffers, 0),
+    m_current(0)
+{
+    glGenBuffers(static_cast<GLsizei>(m_IDs.size()), m_IDs.data());
+}
+
+util::texture::PixelUnpackBufferRing::PixelUnpackBufferRing(
+        util::texture::PixelUnpackBufferRing&& other) :
+    m_IDs(std::move(other.m_IDs)),
+    m_fences(std::move(other.m_fences)),
+    m_capacities(std::move(other.m_capacities)),
+    m_current(other.m_current)
+{
+    other.m_IDs.clear();
+    other.m_fences.clear();
+}
+
+util::texture::PixelUnpackBufferRing&
+util::texture::PixelUnpackBufferRing::operator=(
+        util::texture::PixelUnpackBufferRing&& other)
+{
+    deleteBuffers();
+
+    m_IDs = std::move(other.m_IDs);
+    m_fences = std::move(other.m_fences);
+    m_capacities = std::move(other.m_capacities);
+    m_current = other.m_current;
+    other.m_IDs.clear();
+    other.m_fences.clear();
+
+    return *this;
+}
+
+util::texture::PixelUnpackBufferRing::~PixelUnpackBufferRing()
+{
+    deleteBuffers();
+}
+
+void util::texture::PixelUnpackBufferRing::deleteBuffers()
+{
+    for (GLsync fence : m_fences)
+        if (nullptr != fence)
+            glDeleteSync(fence);
+    m_fences.clear();
+
+    if (!m_IDs.empty())
+        glDeleteBuffers(static_cast<GLsizei>(m_IDs.size()), m_IDs.data());
+    m_IDs.clear();
+}
+
+/**
+ * \brief Maps the next buffer of the ring for writing
+ * \param size           number of bytes that will be written
+ *
+ * \return pointer to the mapped memory or nullptr on failure
+ *
+ * Waits until the last transfer from that buffer has completed, which only
+ * blocks if all buffers of the ring are still in flight.
+ */
+void* util::texture::PixelUnpackBufferRing::map(size_t size)
+{
+    if (m_IDs.empty())
+        return nullptr;
+
+    m_current = (m_current + 1) % m_IDs.size();
+
+    // timeout of a single wait in nanoseconds
+    constexpr GLuint64 waitTimeout = 1000000;
+    GLsync &fence = m_fences[m_current];
+    if (nullptr != fence)
+    {
+        while (GL_TIMEOUT_EXPIRED == glClientWaitSync(
+                fence, GL_SYNC_FLUSH_COMMANDS_BIT, waitTimeout))
+            ;
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_IDs[m_current]);
+    if (m_capacities[m_current] < size)
+    {
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        m_capacities[m_current] = size;
+    }
+
+    // the fence guarantees that the GPU no longer reads the buffer
+    void* ptr = glMapBufferRange(
+        GL_PIXEL_UNPACK_BUFFER,
+        0,
+        size,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+            GL_MAP_UNSYNCHRONIZED_BIT);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    return ptr;
+}
+
+/**
+ * \brief Unmaps the current buffer and updates the texture from it
+ * \param texture        target texture
+ * \param format         format of the data: GL_RGB,...
+ * \param type           data type: GL_UNSIGNED_BYTE, GL_FLOAT,...
+ * \param width          horizontal resolution of the data
+ * \param height         vertical resolution of the data
+ *
+ * \return false if the content of the buffer was lost while it was mapped
+ *         and the texture was not updated, true otherwise
+ */
+bool util::texture::PixelUnpackBufferRing::unmapToTexture(
+    Texture2D& texture,
+    GLenum format,
+    GLenum type,
+    GLsizei width,
+    GLsizei height)
+{
+    if (m_IDs.empty())
+        return false;
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_IDs[m_current]);
+    if (GL_FALSE == glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER))
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return false;
+    }
+
+    // with a bound unpack buffer the data pointer is an offset into it
+    texture.update(format, type, width, height, nullptr);
+    m_fences[m_current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 // convenience functions
 //-----------------------------------------------------------------------------
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <vector>
 
 #include <GL/gl3w.h>
 
@@ -58,6 +59,14 @@ namespace util
 
             void unbind() const;
             void bind() const;
+
+            void update(
+                GLenum format,
+                GLenum type,
+                GLsizei width,
+                GLsizei height,
+                const GLvoid * data,
+                GLint level = 0);
         };
 
         class Texture3D : public Texture
@@ -87,6 +96,78 @@ namespace util
             void unbind() const;
             void bind() const;
         };
+        class Texture2DArray : public Texture
+        {
+            public:
+            Texture2DArray();
+            Texture2DArray(
+                GLenum internalFormat,
+                GLenum format,
+                GLint level,
+                GLenum type,
+                GLint filter,
+                GLint wrap,
+                GLsizei width,
+                GLsizei height,
+                GLsizei layers,
+                const GLvoid * data = static_cast<const GLvoid*>(nullptr),
+                const std::array<float, 4> &borderColor =
+                    {0.f, 0.f, 0.f, 1.f} );
+            Texture2DArray(const Texture2DArray& other) = delete;
+            Texture2DArray(Texture2DArray&& other);
+            Texture2DArray& operator=(const Texture2DArray& other) = delete;
+            Texture2DArray& operator=(Texture2DArray&& other);
+
+            ~Texture2DArray();
+
+            void unbind() const;
+            void bind() const;
+        };
+
+        //---------------------------------------------------------------------
+        // Upload helper classes
+        //---------------------------------------------------------------------
+        /**
+         * \brief Ring of pixel buffer objects for streaming texture uploads
+         *
+         * The next buffer of the ring is mapped and filled by the caller,
+         * afterwards the texture is updated from the buffer. The copy into
+         * the texture is executed asynchronously by the driver, so the CPU
+         * does not have to wait for the transfer to complete.
+         *
+         * The storage of a buffer is only reallocated when it grows. A fence
+         * per buffer tells when its last transfer has completed, so mapping
+         * only waits if all buffers of the ring are still in flight.
+         */
+        class PixelUnpackBufferRing
+        {
+            public:
+            PixelUnpackBufferRing();
+            PixelUnpackBufferRing(size_t numBuffers);
+            PixelUnpackBufferRing(const PixelUnpackBufferRing& other) = delete;
+            PixelUnpackBufferRing(PixelUnpackBufferRing&& other);
+            PixelUnpackBufferRing& operator=(
+                    const PixelUnpackBufferRing& other) = delete;
+            PixelUnpackBufferRing& operator=(PixelUnpackBufferRing&& other);
+            ~PixelUnpackBufferRing();
+
+            void* map(size_t size);
+            bool unmapToTexture(
+                Texture2D& texture,
+                GLenum format,
+                GLenum type,
+                GLsizei width,
+                GLsizei height);
+
+            private:
+            std::vector<GLuint> m_IDs;
+            std::vector<GLsync> m_fences;
+            std::vector<size_t> m_capacities;
+            size_t m_current;
+
+            void deleteBuffers();
+        };
+
         //---------------------------------------------------------------------
         // Convenience Functions
         //---------------------------------------------------------------------
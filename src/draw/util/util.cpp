@@ -57,6 +57,41 @@ util::FramebufferObject::FramebufferObject(
     this->unbind();
 }
 
+/**
+ * \brief Creates a framebuffer object that renders into a single layer of an
+ *        array texture
+ *
+ * \param texture    array texture, has to outlive the framebuffer object
+ * \param layer      index of the layer that is attached
+ * \param attachment attachment point of the layer
+ */
+util::FramebufferObject::FramebufferObject(
+        const util::texture::Texture2DArray &texture,
+        GLint layer,
+        GLenum attachment) :
+    m_ID(0),
+    m_textures(0),
+    m_attachments(1, attachment),
+    m_drawBuffers(0)
+{
+    glGenFramebuffers(1, &m_ID);
+
+    this->bind();
+
+    if ((attachment != GL_DEPTH_ATTACHMENT) &&
+            (attachment != GL_STENCIL_ATTACHMENT))
+        m_drawBuffers.emplace_back(attachment);
+    glFramebufferTextureLayer(
+        GL_FRAMEBUFFER, attachment, texture.getID(), 0, layer);
+
+    printOpenGLError();
+
+    if (!(GL_FRAMEBUFFER_COMPLETE == glCheckFramebufferStatus(GL_FRAMEBUFFER)))
+        std::cerr << "Error: frame buffer object incomplete!" << std::endl;
+
+    this->unbind();
+}
+
 util::FramebufferObject::FramebufferObject(util::FramebufferObject&& other) :
     m_ID(other.m_ID),
     m_textures(std::move(other.m_textures)),
@@ -167,46 +202,3 @@ bool util::checkFile(const std::string& path)
 
     return result;
 }
-
-/**
- *  \brief Grabs the RGB values from the given FBO and writes them to an image
- *         file.
- *
- *  \param fbo object from which the pixel shall be read
- *  \param width horizontal size of the fbo object in pixel
- *  \param height vertical size of the fbo object in pixel
- *  \param file name and path of the target bmp screenshot file
- *  \param type FreeImage Image type (FIF_BMP, FIF_TIFF, ...)
- */
-void util::makeScreenshot(
-        const FramebufferObject &fbo,
-        unsigned int width,
-        unsigned int height,
-        const std::string &file,
-        FREE_IMAGE_FORMAT type)
-{
-    GLubyte* pixels = new GLubyte[3 * width * height];
-
-    fbo.bind();
-
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    glReadPixels(0, 0, width, height, GL_BGR, GL_UNSIGNED_BYTE, pixels);
-
-    // Convert to FreeImage format & save to file
-    FIBITMAP* image = FreeImage_ConvertFromRawBits(
-        pixels,
-        width,
-        height,
-        3 * width,
-        24,
-        0x0000FF,
-        0x00FF00,
-        0xFF0000,
-        false);
-    FreeImage_Save(type, image, file.c_str(), 0);
-
-    // Free resources
-    FreeImage_Unload(image);
-    delete[] pixels;
-}
-
@@ -1,12 +1,19 @@
 #pragma once
 
+#include <array>
 #include <tuple>
+#include <utility>
 #include <vector>
+#include <algorithm>
 #include <cstddef>
 #include <cmath>
 
 #include <boost/multi_array.hpp>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "GL/gl3w.h"
 
 #define GLM_FORCE_SWIZZLE
@@ -18,6 +25,8 @@
 #include "geometry.hpp"
 #include "texture.hpp"
 #include "transferfunc.hpp"
+#include "gputimer.hpp"
+#include "framecapture.hpp"
 
 //-----------------------------------------------------------------------------
 // Macros
@@ -45,13 +54,6 @@ namespace util
 
     bool checkFile(const std::string& path);
 
-    void makeScreenshot(
-        const FramebufferObject &fbo,
-        unsigned int width,
-        unsigned int height,
-        const std::string &file,
-        FREE_IMAGE_FORMAT type);
-
     //-------------------------------------------------------------------------
     // Type definitions
     //-------------------------------------------------------------------------
@@ -62,6 +64,10 @@ namespace util
         FramebufferObject(
             std::vector<util::texture::Texture2D> &&textures,
             const std::vector<GLenum> &attachments);
+        FramebufferObject(
+            const util::texture::Texture2DArray &texture,
+            GLint layer,
+            GLenum attachment);
         FramebufferObject(const FramebufferObject& other) = delete;
         FramebufferObject(FramebufferObject&& other);
         FramebufferObject& operator=(const FramebufferObject& other) = delete;
@@ -87,6 +93,9 @@ namespace util
     };
 
     using bin_t = std::tuple<double, double, unsigned int>;
+
+    // fields with fewer nodes are not worth the threading overhead
+    constexpr size_t PARALLEL_ISOLINE_MIN_NODES = 128 * 128;
     //-------------------------------------------------------------------------
     // Templated functions
     //-------------------------------------------------------------------------
@@ -260,182 +269,520 @@ namespace util
         return bins;
     }
 
+    namespace detail
+    {
+        /**
+         * /brief emits the isoline segments of a single marching squares cell
+         *
+         * /param ul, ur, ll, lr    node values (upper-left, upper-right, ...)
+         * /param isovalue          threshold for which to extract the isolines
+         * /param x, y              position of the upper left node
+         * /param emit              callable taking the segment end points
+         *                          (x1, y1, x2, y2)
+         */
+        template<typename T, class Emit>
+        void marchingSquaresCell(
+            T ul, T ur, T ll, T lr, T isovalue, float x, float y, Emit &emit)
+        {
+            float p1, p2, p3, p4;   // local coordinates of asymptotes
+            T m;                    // value at the middle of a cell
+            unsigned int node_sig = 0;
+
+            // compare nodes of the square to the iso value
+            if (ul >= isovalue) node_sig |= 1u;
+            if (ur >= isovalue) node_sig |= (1u << 1);
+            if (ll >= isovalue) node_sig |= (1u << 2);
+            if (lr >= isovalue) node_sig |= (1u << 3);
+
+            if ((node_sig == 0b1111u) || (node_sig == 0b0000u))
+            {
+                // all nodes above or below isovalue -> no isoline
+                return;
+            }
+            else if ((node_sig == 0b1110u) || (node_sig == 0b0001u))
+            {
+                // upper left corner
+                p1 = static_cast<float>((isovalue - ul) / (ur - ul));
+                p2 = static_cast<float>((isovalue - ul) / (ll - ul));
+
+                emit(x + p1, y, x, y + p2);
+            }
+            else if ((node_sig == 0b1101u) || (node_sig == 0b0010u))
+            {
+                // upper right corner
+                p1 = static_cast<float>((isovalue - ul) / (ur - ul));
+                p2 = static_cast<float>((isovalue - ur) / (lr - ur));
+
+                emit(x + p1, y, x + 1.f, y + p2);
+            }
+            else if ((node_sig == 0b1011u) || (node_sig == 0b0100u))
+            {
+                // lower left corner
+                p1 = static_cast<float>((isovalue - ll) / (lr - ll));
+                p2 = static_cast<float>((isovalue - ul) / (ll - ul));
+
+                emit(x, y + p2, x + p1, y + 1.f);
+            }
+            else if ((node_sig == 0b0111u) || (node_sig == 0b1000u))
+            {
+                // lower right corner
+                p1 = static_cast<float>((isovalue - ll) / (lr - ll));
+                p2 = static_cast<float>((isovalue - ur) / (lr - ur));
+
+                emit(x + 1.f, y + p2, x + p1, y + 1.f);
+            }
+            else if ((node_sig == 0b0011u) || (node_sig == 0b1100u))
+            {
+                // horizontal
+                p1 = static_cast<float>((isovalue - ul) / (ll - ul));
+                p2 = static_cast<float>((isovalue - ur) / (lr - ur));
+
+                emit(x, y + p1, x + 1.f, y + p2);
+            }
+            else if ((node_sig == 0b1010u) || (node_sig == 0b0101u))
+            {
+                // vertical
+                p1 = static_cast<float>((isovalue - ul) / (ur - ul));
+                p2 = static_cast<float>((isovalue - ll) / (lr - ll));
+
+                emit(x + p1, y, x + p2, y + 1.f);
+            }
+            else if ((node_sig == 0b0110u) || (node_sig == 0b1001u))
+            {
+                // ambigous diagonal case
+                p1 = static_cast<float>((isovalue - ul) / (ur - ul));
+                p2 = static_cast<float>((isovalue - ul) / (ll - ul));
+                p3 = static_cast<float>((isovalue - ur) / (lr - ur));
+                p4 = static_cast<float>((isovalue - ll) / (lr - ll));
+
+                m = bilinearInterpolation<T, float>(
+                        ul, ur, ll, lr, 0.5f, 0.5f);
+
+                if (((m >= isovalue) && (node_sig == 0b0110u)) ||
+                    ((m < isovalue) && (node_sig == 0b1001u)))
+                {
+                    // lines from upper right to lower left
+                    emit(x + p1, y, x, y + p2);
+                    emit(x + 1.f, y + p3, x + p4, y + 1.f);
+                }
+                else
+                {
+                    // lines from upper left to lower right
+                    emit(x + p1, y, x + 1.f, y + p3);
+                    emit(x, y + p2, x + p4, y + 1.f);
+                }
+            }
+        }
+    }
+
+    namespace detail
+    {
+        /**
+         * /brief appends the isoline segments of a rectangular block of cells
+         *
+         * /param domain    field data on rectangular 2D domain
+         * /param isoFirst  first of the ascendingly sorted isovalues
+         * /param isoLast   end of the ascendingly sorted isovalues
+         * /param rowBegin  first cell row of the block
+         * /param rowEnd    cell row after the last row of the block
+         * /param colBegin  first cell column of the block
+         * /param colEnd    cell column after the last column of the block
+         * /param vertices  flat array the segment end points are appended to
+         */
+        template<typename T, class Iterator>
+        void extractIsolineCells(
+            const boost::multi_array<T, 2> &domain,
+            Iterator isoFirst,
+            Iterator isoLast,
+            size_t rowBegin,
+            size_t rowEnd,
+            size_t colBegin,
+            size_t colEnd,
+            std::vector<float> &vertices)
+        {
+            auto emit = [&vertices](float x1, float y1, float x2, float y2)
+            {
+                vertices.push_back(x1);
+                vertices.push_back(y1);
+                vertices.push_back(x2);
+                vertices.push_back(y2);
+            };
+
+            for (size_t j = rowBegin; j < rowEnd; j++)
+            {
+                for (size_t i = colBegin; i < colEnd; i++)
+                {
+                    const T ul = domain[j][i];
+                    const T ur = domain[j][i + 1];
+                    const T ll = domain[j + 1][i];
+                    const T lr = domain[j + 1][i + 1];
+
+                    // a cell contains an isoline if min < isovalue <= max
+                    const T cellMin =
+                        std::min(std::min(ul, ur), std::min(ll, lr));
+                    const T cellMax =
+                        std::max(std::max(ul, ur), std::max(ll, lr));
+                    auto first = std::upper_bound(isoFirst, isoLast, cellMin);
+                    auto last = std::upper_bound(first, isoLast, cellMax);
+
+                    for (auto iso = first; iso != last; ++iso)
+                        marchingSquaresCell(
+                            ul, ur, ll, lr, *iso,
+                            static_cast<float>(i), static_cast<float>(j),
+                            emit);
+                }
+            }
+        }
+    }
+
     /**
-     * /brief creates isoline geometry for a given 2D field
+     * /brief creates isoline geometry for several isovalues of a 2D field
      *
      * /param domain    field data on rectangular 2D domain
-     * /param isovalue  threshold for which to extract the isolines
+     * /param isovalues ascendingly sorted thresholds for which to extract
+     *                  the isolines
+     *
+     * /return Flat array of the end points (x1, y1, x2, y2, ...) of the line
+     *         segments that form the respective isolines, ready to be drawn
+     *         as GL_LINES
+     *
+     * All isovalues are handled in a single traversal of the field. Each
+     * cell is visited once and only the isovalues inside its value range
+     * are processed.
      *
-     * /return A vector of lines that form the respective isolines
+     * The cell rows are split into one contiguous band per OpenMP thread.
+     * The segments of the bands are concatenated in band order, so the
+     * result is identical to a sequential run independent of the number
+     * of threads.
      *
      * Note: The position of the lines is derivated from the shape of the
      *       field and results in position from
      *       [0, width - 1] x [0, height - 1].
      */
     template<typename T>
-    std::vector<util::geometry::Line2D> extractIsolines(
-        boost::multi_array<T, 2> domain, T isovalue)
+    std::vector<float> extractIsolines(
+        const boost::multi_array<T, 2> &domain,
+        const std::vector<T> &isovalues)
     {
-        std::vector<util::geometry::Line2D> lines;
-        std::array<float, 4> vertices = {0.f, 0.f, 0.f, 0.f};
-        T ul, ur, ll, lr;   // node values (upper-left, upper-right, ...)
-        float p1, p2, p3, p4;   // local coordinates of asymptotes
-        T m;                // value at the middle of a cell
-        unsigned int node_sig = 0;
-
-        for (size_t j = 0; j < (domain.shape()[1] - 1); j++)
+        std::vector<float> vertices;
+        if (isovalues.empty() ||
+                (domain.shape()[0] < 2) || (domain.shape()[1] < 2))
+            return vertices;
+
+        const size_t numRows = domain.shape()[0] - 1;
+        std::vector<std::vector<float>> bandVertices(1);
+
+        #pragma omp parallel \
+            if(domain.num_elements() >= PARALLEL_ISOLINE_MIN_NODES)
         {
-            for (size_t i = 0; i < (domain.shape()[0] - 1); i++)
-            {
-                // compare nodes of the square to the iso value
-                ul = domain[j][i];
-                ur = domain[j][i + 1];
-                ll = domain[j + 1][i];
-                lr = domain[j + 1][i + 1];
-
-                node_sig = 0;
-                if (ul >= isovalue) node_sig |= 1u;
-                if (ur >= isovalue) node_sig |= (1u << 1);
-                if (ll >= isovalue) node_sig |= (1u << 2);
-                if (lr >= isovalue) node_sig |= (1u << 3);
-
-                if ((node_sig == 0b1111u) || (node_sig == 0b0000u))
-                {
-                    // all nodes above or below isovalue -> no isoline
-                    continue;
-                }
-                else if ((node_sig == 0b1110u) || (node_sig == 0b0001u))
-                {
-                    // upper left corner
+#ifdef _OPENMP
+            #pragma omp single
+            bandVertices.resize(omp_get_num_threads());
+
+            const size_t band = static_cast<size_t>(omp_get_thread_num());
+#else
+            const size_t band = 0;
+#endif
+            const size_t numBands = bandVertices.size();
+
+            detail::extractIsolineCells(
+                domain,
+                isovalues.cbegin(),
+                isovalues.cend(),
+                numRows * band / numBands,
+                numRows * (band + 1) / numBands,
+                0,
+                domain.shape()[1] - 1,
+                bandVertices[band]);
+        }
 
-                    // calculate local coordinates of asymptotes
-                    p1 = static_cast<float>((isovalue - ul) / (ur - ul));
-                    p2 = static_cast<float>((isovalue - ul) / (ll - ul));
+        size_t numVertices = 0;
+        for (const auto &band : bandVertices)
+            numVertices += band.size();
 
-                    vertices[0] = static_cast<float>(i) + p1; // x1
-                    vertices[1] = static_cast<float>(j); // y1
-                    vertices[2] = static_cast<float>(i); // x2
-                    vertices[3] = static_cast<float>(j) + p2; // y2
-                    lines.emplace_back(true, vertices);
-                }
-                else if ((node_sig == 0b1101u) || (node_sig == 0b0010u))
-                {
-                    // upper right corner
+        vertices.reserve(numVertices);
+        for (const auto &band : bandVertices)
+            vertices.insert(vertices.end(), band.cbegin(), band.cend());
 
-                    // calculate local coordinates of asymptotes
-                    p1 = static_cast<float>((isovalue - ul) / (ur - ul));
-                    p2 = static_cast<float>((isovalue - ur) / (lr - ur));
+        return vertices;
+    }
 
-                    vertices[0] = static_cast<float>(i) + p1; // x1
-                    vertices[1] = static_cast<float>(j); // y1
-                    vertices[2] = static_cast<float>(i) + 1.f; // x2
-                    vertices[3] = static_cast<float>(j) + p2; // y2
-                    lines.emplace_back(true, vertices);
-                }
-                else if ((node_sig == 0b1011u) || (node_sig == 0b0100u))
-                {
-                    // lower left corner
+    /**
+     * /brief Tiled min/max pyramid over the cells of a 2D field
+     *
+     * Level 0 stores the value range of tiles of TILE_SIZE x TILE_SIZE
+     * cells, every further level merges 2 x 2 tiles of the level below
+     * until a single tile covers the whole field. It is built once per data
+     * update and lets the isoline extraction skip every tile whose range
+     * does not contain any of the isovalues.
+     */
+    template<typename T>
+    class MinMaxPyramid
+    {
+        public:
+        static constexpr size_t TILE_SIZE = 16;
 
-                    // calculate local coordinates of asymptotes
-                    p1 = static_cast<float>((isovalue - ll) / (lr - ll));
-                    p2 = static_cast<float>((isovalue - ul) / (ll - ul));
+        using range_t = std::pair<T, T>;
+        using tile_t = std::array<size_t, 2>;   //!< (tile row, tile column)
 
-                    vertices[0] = static_cast<float>(i); // x1
-                    vertices[1] = static_cast<float>(j) + p2; // y1
-                    vertices[2] = static_cast<float>(i) + p1; // x2
-                    vertices[3] = static_cast<float>(j) + 1.f; // y2
-                    lines.emplace_back(true, vertices);
-                }
-                else if ((node_sig == 0b0111u) || (node_sig == 0b1000u))
-                {
-                    // lower right corner
+        MinMaxPyramid() : m_levels(), m_numCells{ {0, 0} } {}
 
-                    // calculate local coordinates of asymptotes
-                    p1 = static_cast<float>((isovalue - ll) / (lr - ll));
-                    p2 = static_cast<float>((isovalue - ur) / (lr - ur));
+        /**
+         * /brief (re)builds the pyramid for the given field
+         */
+        void build(const boost::multi_array<T, 2> &domain)
+        {
+            m_numCells[0] = (domain.shape()[0] > 1) ? domain.shape()[0] - 1 : 0;
+            m_numCells[1] = (domain.shape()[1] > 1) ? domain.shape()[1] - 1 : 0;
 
-                    vertices[0] = static_cast<float>(i) + 1.f; // x1
-                    vertices[1] = static_cast<float>(j) + p2; // y1
-                    vertices[2] = static_cast<float>(i) + p1; // x2
-                    vertices[3] = static_cast<float>(j) + 1.f; // y2
-                    lines.emplace_back(true, vertices);
-                }
-                else if ((node_sig == 0b0011u) || (node_sig == 0b1100u))
+            size_t rows = (m_numCells[0] + TILE_SIZE - 1) / TILE_SIZE;
+            size_t cols = (m_numCells[1] + TILE_SIZE - 1) / TILE_SIZE;
+
+            size_t numLevels = 1;
+            for (size_t r = rows, c = cols; (r > 1) || (c > 1); ++numLevels)
+            {
+                r = (r + 1) / 2;
+                c = (c + 1) / 2;
+            }
+            m_levels.resize((rows * cols > 0) ? numLevels : 0);
+            if (m_levels.empty())
+                return;
+
+            // level 0 from the node values covered by the cells of a tile
+            m_levels[0].resize(boost::extents[rows][cols]);
+            #pragma omp parallel for \
+                if(domain.num_elements() >= PARALLEL_ISOLINE_MIN_NODES)
+            for (size_t ty = 0; ty < rows; ++ty)
+            {
+                const size_t yEnd =
+                    std::min((ty + 1) * TILE_SIZE, m_numCells[0]) + 1;
+                for (size_t tx = 0; tx < cols; ++tx)
                 {
-                    // horizontal
-                    // calculate local coordinates of asymptotes
-                    p1 = static_cast<float>((isovalue - ul) / (ll - ul));
-                    p2 = static_cast<float>((isovalue - ur) / (lr - ur));
-
-                    vertices[0] = static_cast<float>(i); // x1
-                    vertices[1] = static_cast<float>(j) + p1; // y1
-                    vertices[2] = static_cast<float>(i) + 1.f; // x2
-                    vertices[3] = static_cast<float>(j) + p2; // y2
-                    lines.emplace_back(true, vertices);
+                    const size_t xEnd =
+                        std::min((tx + 1) * TILE_SIZE, m_numCells[1]) + 1;
+                    range_t range(
+                        domain[ty * TILE_SIZE][tx * TILE_SIZE],
+                        domain[ty * TILE_SIZE][tx * TILE_SIZE]);
+                    for (size_t y = ty * TILE_SIZE; y < yEnd; ++y)
+                    for (size_t x = tx * TILE_SIZE; x < xEnd; ++x)
+                    {
+                        range.first = std::min(range.first, domain[y][x]);
+                        range.second = std::max(range.second, domain[y][x]);
+                    }
+                    m_levels[0][ty][tx] = range;
                 }
-                else if ((node_sig == 0b1010u) || (node_sig == 0b0101u))
+            }
+
+            // coarser levels by merging 2 x 2 tiles
+            for (size_t l = 1; l < m_levels.size(); ++l)
+            {
+                const auto &fine = m_levels[l - 1];
+                const size_t fineRows = fine.shape()[0];
+                const size_t fineCols = fine.shape()[1];
+                rows = (fineRows + 1) / 2;
+                cols = (fineCols + 1) / 2;
+
+                m_levels[l].resize(boost::extents[rows][cols]);
+                for (size_t ty = 0; ty < rows; ++ty)
+                for (size_t tx = 0; tx < cols; ++tx)
                 {
-                    // vertical
+                    const size_t yEnd = std::min(2 * ty + 2, fineRows);
+                    const size_t xEnd = std::min(2 * tx + 2, fineCols);
+                    range_t range = fine[2 * ty][2 * tx];
+                    for (size_t y = 2 * ty; y < yEnd; ++y)
+                    for (size_t x = 2 * tx; x < xEnd; ++x)
+                    {
+                        range.first = std::min(range.first, fine[y][x].first);
+                        range.second =
+                            std::max(range.second, fine[y][x].second);
+                    }
+                    m_levels[l][ty][tx] = range;
+                }
+            }
+        }
 
-                    // calculate local coordinates of asymptotes
-                    p1 = static_cast<float>((isovalue - ul) / (ur - ul));
-                    p2 = static_cast<float>((isovalue - ll) / (lr - ll));
+        /**
+         * /brief number of cells (rows, columns) of the field
+         */
+        const std::array<size_t, 2>& getNumCells() const { return m_numCells; }
+
+        /**
+         * /brief collects the level 0 tiles that contain any isovalue
+         *
+         * /param isovalues ascendingly sorted isovalues
+         *
+         * /return tiles in row-major order
+         */
+        std::vector<tile_t> findActiveTiles(
+            const std::vector<T> &isovalues) const
+        {
+            std::vector<tile_t> tiles;
+            if (!m_levels.empty() && !isovalues.empty())
+                collectActiveTiles(
+                    isovalues, m_levels.size() - 1, 0, 0, tiles);
 
-                    vertices[0] = static_cast<float>(i) + p1; // x1
-                    vertices[1] = static_cast<float>(j); // y1
-                    vertices[2] = static_cast<float>(i) + p2; // x2
-                    vertices[3] = static_cast<float>(j) + 1.f; // y2
-                    lines.emplace_back(true, vertices);
-                }
-                else if ((node_sig == 0b0110u) || (node_sig == 0b1001u))
-                {
-                    // ambigous diagonal case
+            // the depth first descent visits tiles in quadtree order
+            std::sort(tiles.begin(), tiles.end());
 
+            return tiles;
+        }
 
-                    // calculate local coordinates of asymptotes
-                    p1 = static_cast<float>((isovalue - ul) / (ur - ul));
-                    p2 = static_cast<float>((isovalue - ul) / (ll - ul));
-                    p3 = static_cast<float>((isovalue - ur) / (lr - ur));
-                    p4 = static_cast<float>((isovalue - ll) / (lr - ll));
+        /**
+         * /brief cell ranges [rowBegin, rowEnd, colBegin, colEnd) of a tile
+         */
+        std::array<size_t, 4> getTileCells(const tile_t &tile) const
+        {
+            return {
+                tile[0] * TILE_SIZE,
+                std::min((tile[0] + 1) * TILE_SIZE, m_numCells[0]),
+                tile[1] * TILE_SIZE,
+                std::min((tile[1] + 1) * TILE_SIZE, m_numCells[1]) };
+        }
 
-                    m = bilinearInterpolation<T, float>(ul, ur, ll, lr, 0.5f, 0.5f);
+        /**
+         * /brief value range of a level 0 tile
+         */
+        const range_t& getTileRange(const tile_t &tile) const
+        {
+            return m_levels[0][tile[0]][tile[1]];
+        }
 
-                    if (((m >= isovalue) && (node_sig == 0b0110u)) ||
-                        ((m < isovalue) && (node_sig == 0b1001u)))
-                    {
-                        // lines from upper right to lower left
-                        vertices[0] = static_cast<float>(i) + p1; // x1
-                        vertices[1] = static_cast<float>(j); // y1
-                        vertices[2] = static_cast<float>(i); // x2
-                        vertices[3] = static_cast<float>(j) + p2; // y2
-                        lines.emplace_back(true, vertices);
-
-                        vertices[0] = static_cast<float>(i) + 1.f; // x1
-                        vertices[1] = static_cast<float>(j) + p3; // y1
-                        vertices[2] = static_cast<float>(i) + p4; // x2
-                        vertices[3] = static_cast<float>(j) + 1.f; // y2
-                        lines.emplace_back(true, vertices);
-                    }
-                    else
-                    {
-                        // lines from upper left to lower right
-                        vertices[0] = static_cast<float>(i) + p1; // x1
-                        vertices[1] = static_cast<float>(j); // y1
-                        vertices[2] = static_cast<float>(i) + 1.f; // x2
-                        vertices[3] = static_cast<float>(j) + p3; // y2
-                        lines.emplace_back(true, vertices);
-
-                        vertices[0] = static_cast<float>(i); // x1
-                        vertices[1] = static_cast<float>(j) + p2; // y1
-                        vertices[2] = static_cast<float>(i) + p4; // x2
-                        vertices[3] = static_cast<float>(j) + 1.f; // y2
-                        lines.emplace_back(true, vertices);
-                    }
-                }
+        private:
+        std::vector<boost::multi_array<range_t, 2>> m_levels;
+        std::array<size_t, 2> m_numCells;
+
+        static bool containsIsovalue(
+            const std::vector<T> &isovalues, const range_t &range)
+        {
+            // same criterion as for single cells: min < isovalue <= max
+            auto it = std::upper_bound(
+                    isovalues.cbegin(), isovalues.cend(), range.first);
+            return (it != isovalues.cend()) && (*it <= range.second);
+        }
+
+        void collectActiveTiles(
+            const std::vector<T> &isovalues,
+            size_t level,
+            size_t ty,
+            size_t tx,
+            std::vector<tile_t> &tiles) const
+        {
+            const auto &tileLevel = m_levels[level];
+            if ((ty >= tileLevel.shape()[0]) || (tx >= tileLevel.shape()[1]))
+                return;
+            if (!containsIsovalue(isovalues, tileLevel[ty][tx]))
+                return;
+
+            if (0 == level)
+            {
+                tiles.push_back({ty, tx});
+                return;
+            }
+
+            for (size_t y = 2 * ty; y < 2 * ty + 2; ++y)
+            for (size_t x = 2 * tx; x < 2 * tx + 2; ++x)
+                collectActiveTiles(isovalues, level - 1, y, x, tiles);
+        }
+    };
+
+    /**
+     * /brief creates isoline geometry for several isovalues of a 2D field,
+     *        skipping all tiles that cannot contain any isoline
+     *
+     * /param domain    field data on rectangular 2D domain
+     * /param isovalues ascendingly sorted thresholds for which to extract
+     *                  the isolines
+     * /param pyramid   min/max pyramid that was built from domain
+     *
+     * /return Flat array of the end points (x1, y1, x2, y2, ...) of the line
+     *         segments that form the respective isolines
+     *
+     * The active tiles are distributed in contiguous chunks over the OpenMP
+     * threads and concatenated in tile order, so the result does not depend
+     * on the number of threads.
+     */
+    template<typename T>
+    std::vector<float> extractIsolines(
+        const boost::multi_array<T, 2> &domain,
+        const std::vector<T> &isovalues,
+        const MinMaxPyramid<T> &pyramid)
+    {
+        std::vector<float> vertices;
+        if (isovalues.empty() ||
+                (domain.shape()[0] < 2) || (domain.shape()[1] < 2))
+            return vertices;
+
+        const std::vector<typename MinMaxPyramid<T>::tile_t> tiles =
+            pyramid.findActiveTiles(isovalues);
+        std::vector<std::vector<float>> chunkVertices(1);
+
+        #pragma omp parallel \
+            if(tiles.size() * MinMaxPyramid<T>::TILE_SIZE * \
+                MinMaxPyramid<T>::TILE_SIZE >= PARALLEL_ISOLINE_MIN_NODES)
+        {
+#ifdef _OPENMP
+            #pragma omp single
+            chunkVertices.resize(omp_get_num_threads());
+
+            const size_t chunk = static_cast<size_t>(omp_get_thread_num());
+#else
+            const size_t chunk = 0;
+#endif
+            const size_t numChunks = chunkVertices.size();
+            const size_t tileEnd = tiles.size() * (chunk + 1) / numChunks;
+
+            for (size_t t = tiles.size() * chunk / numChunks; t < tileEnd; ++t)
+            {
+                // only the isovalues inside the tile range are relevant
+                const auto &range = pyramid.getTileRange(tiles[t]);
+                auto isoFirst = std::upper_bound(
+                        isovalues.cbegin(), isovalues.cend(), range.first);
+                auto isoLast = std::upper_bound(
+                        isoFirst, isovalues.cend(), range.second);
+
+                const std::array<size_t, 4> cells =
+                    pyramid.getTileCells(tiles[t]);
+                detail::extractIsolineCells(
+                    domain,
+                    isoFirst,
+                    isoLast,
+                    cells[0],
+                    cells[1],
+                    cells[2],
+                    cells[3],
+                    chunkVertices[chunk]);
             }
         }
 
-        return lines;
+        size_t numVertices = 0;
+        for (const auto &chunk : chunkVertices)
+            numVertices += chunk.size();
+
+        vertices.reserve(numVertices);
+        for (const auto &chunk : chunkVertices)
+            vertices.insert(vertices.end(), chunk.cbegin(), chunk.cend());
+
+        return vertices;
+    }
+
+    /**
+     * /brief creates isoline geometry for a given 2D field
+     *
+     * /param domain    field data on rectangular 2D domain
+     * /param isovalue  threshold for which to extract the isolines
+     *
+     * /return Flat array of the end points (x1, y1, x2, y2, ...) of the line
+     *         segments that form the respective isolines
+     *
+     * Note: The position of the lines is derivated from the shape of the
+     *       field and results in position from
+     *       [0, width - 1] x [0, height - 1].
+     */
+    template<typename T>
+    std::vector<float> extractIsolines(
+        const boost::multi_array<T, 2> &domain, T isovalue)
+    {
+        return extractIsolines(domain, std::vector<T>(1, isovalue));
     }
 }
 
@@ -1,10 +1,18 @@
 #include <iostream>
 #include <cstdlib>
 #include <array>
+#include <chrono>
 #include <cstdio>
 #include <cmath>
+#include <cstdint>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include <boost/multi_array.hpp>
 
@@ -13,6 +21,16 @@ namespace po = boost::program_options;
 
 #include "draw/draw.hpp"
 #include "adapter/inpreciceadapter.hpp"
+#include "adapter/replaysource.hpp"
+#include "adapter/mocksource.hpp"
+#include "trace/trace.hpp"
+
+//-----------------------------------------------------------------------------
+// constants
+//-----------------------------------------------------------------------------
+// number of fractures drawn for the fracture network of case 2
+constexpr size_t NUM_NETWORK_FRACTURES =
+    std::tuple_size<draw::Renderer::fractureDataArray_t>::value;
 
 //-----------------------------------------------------------------------------
 // types
@@ -22,8 +40,38 @@ struct ProgramSettings
     std::string meshFile;
     std::string preciceConfig;
     int bmCase;
+    bool eventDriven;
+    size_t historyLength;
+    std::string recordingFile;
+    std::string replayFile;
+    double replayRate;
+    size_t mockFractures;
+    std::array<size_t, 2> mockGridDimension;
+    double mockRate;
+    uint64_t mockSteps;
+    std::string traceFile;
+    std::array<unsigned int, 2> windowSize;
+    std::string headlessDirectory;
+    uint64_t frameInterval;
 
-    ProgramSettings() : meshFile(), preciceConfig(), bmCase(1) {}
+    ProgramSettings() :
+        meshFile(),
+        preciceConfig(),
+        bmCase(1),
+        eventDriven(false),
+        historyLength(0),
+        recordingFile(),
+        replayFile(),
+        replayRate(0.),
+        mockFractures(0),
+        mockGridDimension({{512, 512}}),
+        mockRate(30.),
+        mockSteps(0),
+        traceFile(),
+        windowSize({{1280, 720}}),
+        headlessDirectory(),
+        frameInterval(1)
+    {}
     ProgramSettings(
             const std::string &mesh,
             const std::string &preciceConf) :
@@ -37,6 +85,18 @@ struct ProgramSettings
 // function prototypes
 //-----------------------------------------------------------------------------
 int applyProgramOptions(int argc, char *argv[], ProgramSettings &settings);
+int runVisualization(
+        inpreciceadapter::DataSource &source,
+        draw::Renderer &renderer,
+        const ProgramSettings &settings);
+int runHeadless(
+        inpreciceadapter::DataSource &source,
+        draw::Renderer &renderer,
+        const ProgramSettings &settings);
+int drawSnapshot(
+        draw::Renderer &renderer,
+        const inpreciceadapter::VisualizationSnapshot &snapshot,
+        int bmCase);
 
 //-----------------------------------------------------------------------------
 // function implementations
@@ -55,7 +115,8 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
-    draw::Renderer renderer;
+    draw::Renderer renderer(settings.windowSize[0], settings.windowSize[1]);
+    renderer.setHeadless(!settings.headlessDirectory.empty());
     if (EXIT_SUCCESS == renderer.initialize())
         std::cout << "Renderer was successfully initialized!" << std::endl;
     else
@@ -64,54 +125,268 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
-    inpreciceadapter::InpreciceAdapter interface(
-        "Visualization", settings.preciceConfig, settings.bmCase, 0, 1);
-    interface.initialize(settings.meshFile);
+    // replay a recording or generate synthetic data instead of coupling to
+    // a solver
+    std::unique_ptr<inpreciceadapter::DataSource> source;
+    if (!settings.replayFile.empty())
+        source = std::make_unique<inpreciceadapter::ReplaySource>(
+            settings.replayFile, settings.replayRate);
+    else if (settings.mockFractures > 0)
+        source = std::make_unique<inpreciceadapter::MockSource>(
+            settings.mockFractures,
+            settings.mockGridDimension,
+            settings.mockRate,
+            settings.mockSteps);
+    else
+    {
+        // the case is checked before preCICE gets initialized
+        if ((settings.bmCase != 1) && (settings.bmCase != 2))
+        {
+            std::cout << "Error: Unsupported benchmark case!" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        auto interface = std::make_unique<inpreciceadapter::InpreciceAdapter>(
+            "Visualization", settings.preciceConfig, settings.bmCase, 0, 1);
+        interface->setVisualizationMesh(settings.meshFile);
+        source = std::move(interface);
+    }
+
+    source->setHistoryLength(settings.historyLength);
+    if (!settings.recordingFile.empty())
+        source->setRecordingFile(settings.recordingFile);
+    try
+    {
+        source->initialize();
+    }
+    catch(std::exception &e)
+    {
+        std::cout << "Error: Data source initialization failed!" << std::endl;
+        std::cout << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // without preCICE the case follows from the number of fractures, only
+    // the first nine fractures of a network are drawn
+    if (!settings.replayFile.empty() || (settings.mockFractures > 0))
+    {
+        const size_t numFractures = source->getLayout().size();
+        if (numFractures == 1)
+            settings.bmCase = 1;
+        else if (numFractures >= NUM_NETWORK_FRACTURES)
+            settings.bmCase = 2;
+        else
+        {
+            std::cout << "Error: A single fracture or at least "
+                << NUM_NETWORK_FRACTURES
+                << " fractures are needed for drawing!" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // only render when new data or input events arrive, the callback has to
+    // be set before the producer thread publishes the first time step
+    if (settings.headlessDirectory.empty() && settings.eventDriven)
+    {
+        renderer.setEventDriven(true);
+        source->setPublishCallback(draw::Renderer::wakeUp);
+    }
+
+    // produce the data on its own thread
+    source->runThreaded();
+
+    if (!settings.headlessDirectory.empty())
+        return runHeadless(*source, renderer, settings);
 
-    // Run precice (runs a thread)
-    interface.runCouplingThreaded();
+    return runVisualization(*source, renderer, settings);
+}
+
+/**
+ * \brief Draws the time steps provided by a data source until the window is
+ *        closed
+ *
+ * \param source    running data source
+ * \param renderer  initialized renderer
+ * \param settings  settings of the program, with a supported benchmark case
+ *
+ * \return  EXIT_SUCCESS
+ */
+int runVisualization(
+        inpreciceadapter::DataSource &source,
+        draw::Renderer &renderer,
+        const ProgramSettings &settings)
+{
+    TRACE_THREAD_NAME("main");
+    if (!settings.traceFile.empty())
+        trace::start();
 
-    // get data from coupling and draw it
+    // get data from the source and draw it, the drawn snapshot is kept
+    // until another time step is drawn, so the renderer never sees
+    // recycled data
     bool run = true;
     int ret = EXIT_SUCCESS;
+    inpreciceadapter::VisualizationSnapshotPtr_t snapshot;
     while(run)
     {
-        const inpreciceadapter::VisualizationDataInfoVec_t visData =
-                interface.getVisualisationData();
-        if (settings.bmCase == 1)
-            ret = renderer.drawSingleFracture(visData[0].buffers[0]);
-        else if (settings.bmCase == 2)
-        {
-            const draw::Renderer::fractureDataArray_t dataArray = {
-                visData[0].buffers[0],
-                visData[1].buffers[0],
-                visData[2].buffers[0],
-                visData[3].buffers[0],
-                visData[4].buffers[0],
-                visData[5].buffers[0],
-                visData[6].buffers[0],
-                visData[7].buffers[0],
-                visData[8].buffers[0]};
-
-            ret = renderer.drawFractureNetwork(dataArray);
-        }
-        else
+        TRACE_SCOPE("frame");
+
+        inpreciceadapter::VisualizationSnapshotPtr_t next =
+                source.getVisualisationData();
+
+        // show an older time step from the history if selected in the menu
+        renderer.setTimeStepRange(
+                source.getOldestHistoryVersion(next->version),
+                next->version);
+        if (!renderer.isFollowingLatestTimeStep())
         {
-            std::cout << "Error: Unsupported benchmark case!" << std::endl;
-            return EXIT_FAILURE;
+            inpreciceadapter::VisualizationSnapshotPtr_t selected =
+                source.getHistorySnapshot(renderer.getSelectedTimeStep());
+            if (nullptr != selected)
+                next = std::move(selected);
         }
+        if ((nullptr == snapshot) || (next->version != snapshot->version))
+            snapshot = std::move(next);
 
+        ret = drawSnapshot(renderer, *snapshot, settings.bmCase);
         if (EXIT_FAILURE == ret)
             std::cout << "Error: Renderer draw call reported a failure!\n";
 
-      run = renderer.processEvents();
+        {
+            TRACE_SCOPE("processEvents");
+            run = renderer.processEvents();
+        }
     }
 
-    interface.finalize();
+    source.finalize();
+
+    if (!settings.traceFile.empty())
+    {
+        trace::stop();
+        trace::writeChromeTrace(settings.traceFile);
+    }
 
     return EXIT_SUCCESS;
 }
 
+/**
+ * \brief Draws the time steps provided by a data source without a window
+ *        and writes every frameInterval-th time step as image until the
+ *        source has finished
+ *
+ * \param source    running data source
+ * \param renderer  initialized headless renderer
+ * \param settings  settings of the program, with a supported benchmark case
+ *
+ * \return  EXIT_SUCCESS or EXIT_FAILURE if drawing or writing an image failed
+ *
+ * Time steps that were already replaced by newer ones when the drawing of
+ * the previous image finished are taken from the history. If they are no
+ * longer kept there, their images are missing.
+ */
+int runHeadless(
+        inpreciceadapter::DataSource &source,
+        draw::Renderer &renderer,
+        const ProgramSettings &settings)
+{
+    TRACE_THREAD_NAME("main");
+    if (!settings.traceFile.empty())
+        trace::start();
+
+    const uint64_t interval = settings.frameInterval;
+    uint64_t checkedVersion = 0;
+    size_t numWrittenFrames = 0;
+    size_t numMissedFrames = 0;
+    int ret = EXIT_SUCCESS;
+    bool finished = false;
+    while (!finished && (EXIT_SUCCESS == ret))
+    {
+        // checked before taking the latest snapshot, so the last time step
+        // is not lost
+        finished = source.isFinished();
+        const inpreciceadapter::VisualizationSnapshotPtr_t latest =
+            source.getVisualisationData();
+
+        // all time steps due for an image since the last check
+        for (uint64_t version = (checkedVersion / interval + 1) * interval;
+                (version <= latest->version) && (EXIT_SUCCESS == ret);
+                version += interval)
+        {
+            const inpreciceadapter::VisualizationSnapshotPtr_t snapshot =
+                (version == latest->version) ?
+                latest : source.getHistorySnapshot(version);
+            if (nullptr == snapshot)
+            {
+                ++numMissedFrames;
+                continue;
+            }
+
+            TRACE_SCOPE("frame");
+            std::ostringstream file;
+            file << settings.headlessDirectory << "/frame_"
+                << std::setw(8) << std::setfill('0') << version << ".png";
+
+            ret = drawSnapshot(renderer, *snapshot, settings.bmCase);
+            if (EXIT_SUCCESS == ret)
+                ret = renderer.saveFrame(file.str());
+            if (EXIT_SUCCESS == ret)
+                ++numWrittenFrames;
+        }
+        checkedVersion = latest->version;
+
+        if (!finished)
+            source.waitForData(checkedVersion, std::chrono::seconds(1));
+    }
+
+    source.finalize();
+    if (EXIT_FAILURE == renderer.finishFrameCapture())
+        ret = EXIT_FAILURE;
+
+    if (!settings.traceFile.empty())
+    {
+        trace::stop();
+        trace::writeChromeTrace(settings.traceFile);
+    }
+
+    std::cout << "Wrote " << numWrittenFrames << " images to "
+        << settings.headlessDirectory << std::endl;
+    if (numMissedFrames > 0)
+        std::cerr << "Warning: " << numMissedFrames << " images are missing "
+            "as drawing was too slow, keep more time steps with --history!"
+            << std::endl;
+
+    return ret;
+}
+
+/**
+ * \brief Draws a time step with the renderer of the given benchmark case
+ *
+ * \return  EXIT_SUCCESS or EXIT_FAILURE if the renderer reported a failure
+ */
+int drawSnapshot(
+        draw::Renderer &renderer,
+        const inpreciceadapter::VisualizationSnapshot &snapshot,
+        int bmCase)
+{
+    const inpreciceadapter::VisualizationDataInfoVec_t& visData =
+            snapshot.data;
+    if (bmCase == 1)
+        return renderer.drawSingleFracture(
+                visData[0].buffers[0], snapshot.version);
+
+    const draw::Renderer::fractureDataArray_t dataArray = {
+        visData[0].buffers[0],
+        visData[1].buffers[0],
+        visData[2].buffers[0],
+        visData[3].buffers[0],
+        visData[4].buffers[0],
+        visData[5].buffers[0],
+        visData[6].buffers[0],
+        visData[7].buffers[0],
+        visData[8].buffers[0]};
+
+    return renderer.drawFractureNetwork(dataArray, snapshot.version);
+}
+
 /**
  * \brief Takes in input arguments, parses and loads the specified data
  *
@@ -133,7 +408,56 @@ int applyProgramOptions(int argc, char *argv[], ProgramSettings &settings)
         ("help,h", "produce help message")
         ("mesh,m",
          po::value<std::string>(),
-         "json file containing the visualization meshes")
+         "json or binary file containing the visualization meshes")
+        ("history",
+         po::value<size_t>(),
+         "number of recent time steps kept in memory for browsing back in "
+         "time (default: 0)")
+        ("record,r",
+         po::value<std::string>(),
+         "record all received time steps to the given file")
+        ("replay",
+         po::value<std::string>(),
+         "replay a recording instead of coupling to a solver, the preCICE "
+         "configuration and case are not needed")
+        ("replay-rate",
+         po::value<double>(),
+         "time steps per second shown when replaying (default: 0, as fast "
+         "as possible)")
+        ("mock",
+         po::value<size_t>(),
+         "show synthetic data of the given number of fractures instead of "
+         "coupling to a solver")
+        ("mock-grid",
+         po::value< std::vector<size_t> >()->multitoken(),
+         "grid dimension of the synthetic fractures, one value for square "
+         "grids (default: 512 512)")
+        ("mock-rate",
+         po::value<double>(),
+         "synthetic time steps per second, 0 for as fast as possible "
+         "(default: 30)")
+        ("mock-steps",
+         po::value<uint64_t>(),
+         "number of synthetic time steps (default: 0, unlimited)")
+        ("trace",
+         po::value<std::string>(),
+         "record a Chrome trace of the whole session to the given file, "
+         "press F8 to record one on demand instead")
+        ("window-size",
+         po::value< std::vector<unsigned int> >()->multitoken(),
+         "window size, also the resolution of the images written in "
+         "headless mode (default: 1280 720)")
+        ("headless",
+         po::value<std::string>(),
+         "render without a window and write the time steps as images into "
+         "the given directory until the data source has finished")
+        ("frame-interval",
+         po::value<uint64_t>(),
+         "write an image of every n-th time step in headless mode "
+         "(default: 1)")
+        ("event-driven,e",
+         "only render when new data or input events arrive instead of "
+         "continuously")
     ;
 
     // positional arguments are hidden options
@@ -167,29 +491,90 @@ int applyProgramOptions(int argc, char *argv[], ProgramSettings &settings)
         {
             std::cout <<
                 "Usage: inpreCICE [options] PRECICE-CONFIG-PATH CASE-NUMBER\n"
+                "       inpreCICE [options] --replay RECORDING\n"
+                "       inpreCICE [options] --mock FRACTURES\n"
                 << std::endl;
             std::cout << generic << std::endl;
             exit(EXIT_SUCCESS);
         }
 
-        if (    (vm.count("precice-config") != 1) ||
-                (vm.count("case") != 1) )
+        if (vm.count("replay") > 0)
+            settings.replayFile = vm["replay"].as<std::string>();
+
+        if (vm.count("replay-rate") > 0)
+            settings.replayRate = vm["replay-rate"].as<double>();
+
+        if (vm.count("mock") > 0)
+            settings.mockFractures = vm["mock"].as<size_t>();
+
+        if (vm.count("mock-grid") > 0)
+        {
+            const auto& grid = vm["mock-grid"].as< std::vector<size_t> >();
+            if ((grid.size() < 1) || (grid.size() > 2))
+                throw std::runtime_error(
+                    "--mock-grid expects one or two grid dimensions");
+            settings.mockGridDimension = {{ grid.front(), grid.back() }};
+        }
+
+        if (vm.count("mock-rate") > 0)
+            settings.mockRate = vm["mock-rate"].as<double>();
+
+        if (vm.count("mock-steps") > 0)
+            settings.mockSteps = vm["mock-steps"].as<uint64_t>();
+
+        if (settings.replayFile.empty() && (0 == settings.mockFractures) && (
+                (vm.count("precice-config") != 1) ||
+                (vm.count("case") != 1) ))
         {
             std::cout <<
                 "Usage: inpreCICE [options] PRECICE-CONFIG-PATH CASE-NUMBER\n"
+                "       inpreCICE [options] --replay RECORDING\n"
+                "       inpreCICE [options] --mock FRACTURES\n"
                 << std::endl;
             std::cout << generic << std::endl;
             exit(EXIT_FAILURE);
         }
-        else
-        {
+
+        if (vm.count("precice-config") > 0)
             settings.preciceConfig = vm["precice-config"].as<std::string>();
+        if (vm.count("case") > 0)
             settings.bmCase = vm["case"].as<int>();
-        }
 
 
         if (vm.count("mesh") > 0)
             settings.meshFile = vm["mesh"].as<std::string>();
+
+        settings.eventDriven = (vm.count("event-driven") > 0);
+
+        if (vm.count("history") > 0)
+            settings.historyLength = vm["history"].as<size_t>();
+
+        if (vm.count("trace") > 0)
+            settings.traceFile = vm["trace"].as<std::string>();
+
+        if (vm.count("record") > 0)
+            settings.recordingFile = vm["record"].as<std::string>();
+
+        if (vm.count("window-size") > 0)
+        {
+            const auto& size = vm["window-size"].as<
+                std::vector<unsigned int> >();
+            if (size.size() != 2)
+                throw std::runtime_error(
+                    "--window-size expects a width and a height");
+            settings.windowSize = {{ size[0], size[1] }};
+        }
+
+        if (vm.count("headless") > 0)
+            settings.headlessDirectory = vm["headless"].as<std::string>();
+
+        if (vm.count("frame-interval") > 0)
+        {
+            settings.frameInterval = vm["frame-interval"].as<uint64_t>();
+            if (0 == settings.frameInterval)
+                throw std::runtime_error(
+                    "--frame-interval has to be at least 1");
+        }
     }
     catch(std::exception &e)
     {
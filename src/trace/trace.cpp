@@ -0,0 +1,236 @@
+#include "trace.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> trace::detail::recording(false);
+
+namespace {
+
+// bounds the memory of long recordings, later events are dropped
+constexpr size_t MAX_EVENTS_PER_THREAD = 1 << 20;
+
+struct Event
+{
+    const char* name;
+    int64_t beginNs;
+    int64_t durationNs;
+};
+
+/**
+ * \brief Events of one thread
+ *
+ * The mutex is only contended while a trace is started or written.
+ */
+struct ThreadBuffer
+{
+    std::mutex mutex;
+    unsigned int tid{0};
+    std::string name{};
+    std::vector<Event> events{};
+    size_t numDroppedEvents{0};
+};
+
+std::mutex g_registryMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> g_threadBuffers;
+std::map<std::string, std::shared_ptr<ThreadBuffer>> g_trackBuffers;
+
+// begin of the trace, guarded by g_registryMutex
+int64_t g_startNs = 0;
+
+int64_t toNs(trace::clock_t::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        time.time_since_epoch()).count();
+}
+
+/**
+ * \brief Returns the buffer of the calling thread, registered on first use
+ *
+ * The registry keeps the buffer alive after the thread has ended, so its
+ * events are still written.
+ */
+ThreadBuffer& accessThreadBuffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer)
+    {
+        buffer = std::make_shared<ThreadBuffer>();
+
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        buffer->tid = static_cast<unsigned int>(g_threadBuffers.size() + 1);
+        g_threadBuffers.push_back(buffer);
+    }
+
+    return *buffer;
+}
+
+/**
+ * \brief Returns the buffer of a named track, registered on first use
+ */
+ThreadBuffer& accessTrackBuffer(const char* track)
+{
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    std::shared_ptr<ThreadBuffer>& buffer = g_trackBuffers[track];
+    if (!buffer)
+    {
+        buffer = std::make_shared<ThreadBuffer>();
+        buffer->tid = static_cast<unsigned int>(g_threadBuffers.size() + 1);
+        buffer->name = track;
+        g_threadBuffers.push_back(buffer);
+    }
+
+    return *buffer;
+}
+
+void addBufferEvent(
+        ThreadBuffer& buffer,
+        const char* name,
+        trace::clock_t::time_point begin,
+        trace::clock_t::time_point end)
+{
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.events.size() < MAX_EVENTS_PER_THREAD)
+        buffer.events.push_back({name, toNs(begin), toNs(end) - toNs(begin)});
+    else
+        ++buffer.numDroppedEvents;
+}
+
+/**
+ * \brief Writes a string as JSON string literal
+ */
+void writeJsonString(std::ostream& os, const std::string& str)
+{
+    os << '"';
+    for (const char c : str)
+    {
+        if ((c == '"') || (c == '\\'))
+            os << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            os << escaped;
+        }
+        else
+            os << c;
+    }
+    os << '"';
+}
+
+} // namespace
+
+void trace::start()
+{
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    for (const auto& buffer : g_threadBuffers)
+    {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->events.clear();
+        buffer->numDroppedEvents = 0;
+    }
+    g_startNs = toNs(clock_t::now());
+
+    detail::recording.store(true, std::memory_order_relaxed);
+}
+
+void trace::stop()
+{
+    detail::recording.store(false, std::memory_order_relaxed);
+}
+
+void trace::setThreadName(const char* name)
+{
+    ThreadBuffer& buffer = accessThreadBuffer();
+
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.name = name;
+}
+
+void trace::addEvent(
+        const char* name, clock_t::time_point begin, clock_t::time_point end)
+{
+    addBufferEvent(accessThreadBuffer(), name, begin, end);
+}
+
+void trace::addTrackEvent(
+        const char* track,
+        const char* name,
+        clock_t::time_point begin,
+        clock_t::time_point end)
+{
+    addBufferEvent(accessTrackBuffer(track), name, begin, end);
+}
+
+int trace::writeChromeTrace(const std::string& path)
+{
+    std::ofstream fs(path.c_str());
+    if (!fs.good())
+    {
+        std::cerr << "Error: Could not write trace " << path << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+
+    // timestamps are in microseconds relative to the start of the trace
+    fs << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    fs << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+        "\"args\":{\"name\":\"inpreCICE\"}}";
+
+    size_t numEvents = 0;
+    size_t numDroppedEvents = 0;
+    char timing[64];
+    for (const auto& buffer : g_threadBuffers)
+    {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        if (!buffer->name.empty())
+        {
+            fs << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                "\"tid\":" << buffer->tid << ",\"args\":{\"name\":";
+            writeJsonString(fs, buffer->name);
+            fs << "}}";
+        }
+
+        for (const Event& event : buffer->events)
+        {
+            if (event.beginNs < g_startNs)
+                continue;
+
+            fs << ",\n{\"name\":";
+            writeJsonString(fs, event.name);
+            std::snprintf(
+                timing,
+                sizeof(timing),
+                "\"ts\":%.3f,\"dur\":%.3f",
+                1e-3 * (event.beginNs - g_startNs),
+                1e-3 * event.durationNs);
+            fs << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid << ","
+                << timing << "}";
+        }
+        numEvents += buffer->events.size();
+        numDroppedEvents += buffer->numDroppedEvents;
+    }
+    fs << "\n]}\n";
+
+    if (!fs.good())
+    {
+        std::cerr << "Error: Could not write trace " << path << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Saved trace with " << numEvents << " events to " << path
+        << std::endl;
+    if (numDroppedEvents > 0)
+        std::cerr << "Warning: " << numDroppedEvents << " events were "
+            "dropped, the trace was recorded for too long!" << std::endl;
+
+    return EXIT_SUCCESS;
+}
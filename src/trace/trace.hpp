@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+/**
+ * \brief Scoped timers for finding out where the time of a session goes
+ *
+ * TRACE_SCOPE("name") measures the enclosing scope on the calling thread.
+ * Events are only collected between trace::start() and trace::stop() and
+ * can be written as Chrome trace JSON, which is shown by chrome://tracing
+ * and https://ui.perfetto.dev. While no trace is recorded, a timer costs a
+ * single relaxed atomic load.
+ *
+ * The macros are compiled out completely unless INPRECICE_TRACE is defined
+ * (see TRACE in the Makefile). The functions stay available, so traces can
+ * still be started and written, they just contain no events.
+ *
+ * Names have to be string literals or otherwise outlive the trace.
+ */
+namespace trace
+{
+    using clock_t = std::chrono::steady_clock;
+
+    /**
+     * \brief Discards all collected events and starts collecting new ones
+     */
+    void start();
+
+    /**
+     * \brief Stops collecting events, collected events are kept
+     */
+    void stop();
+
+    namespace detail
+    {
+        extern std::atomic<bool> recording;
+    }
+
+    inline bool isRecording()
+    {
+        return detail::recording.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Names the calling thread in the trace
+     */
+    void setThreadName(const char* name);
+
+    /**
+     * \brief Adds a complete event of the calling thread to the trace
+     */
+    void addEvent(
+            const char* name,
+            clock_t::time_point begin,
+            clock_t::time_point end);
+
+    /**
+     * \brief Adds a complete event to a named track of the trace
+     *
+     * Tracks are shown like threads, they hold events that were not measured
+     * on a CPU thread, e.g. GPU times.
+     */
+    void addTrackEvent(
+            const char* track,
+            const char* name,
+            clock_t::time_point begin,
+            clock_t::time_point end);
+
+    /**
+     * \brief Writes all collected events as Chrome trace JSON
+     *
+     * \return EXIT_SUCCESS or EXIT_FAILURE if the file could not be written
+     */
+    int writeChromeTrace(const std::string& path);
+
+    /**
+     * \brief Adds an event for its own lifetime to the trace
+     */
+    class ScopedTimer
+    {
+        public:
+        explicit ScopedTimer(const char* name) :
+            name_(isRecording() ? name : nullptr),
+            begin_(name_ ? clock_t::now() : clock_t::time_point())
+        {
+        }
+        ScopedTimer( const ScopedTimer& ) = delete;
+        ScopedTimer& operator=( const ScopedTimer& ) = delete;
+
+        ~ScopedTimer()
+        {
+            if (name_)
+                addEvent(name_, begin_, clock_t::now());
+        }
+
+        private:
+        const char* name_;
+        clock_t::time_point begin_;
+    };
+}
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+#ifdef INPRECICE_TRACE
+#define TRACE_SCOPE(name) \
+    trace::ScopedTimer TRACE_CONCAT(traceScopedTimer, __LINE__)(name)
+#define TRACE_THREAD_NAME(name) trace::setThreadName(name)
+#else
+#define TRACE_SCOPE(name) do {} while (false)
+#define TRACE_THREAD_NAME(name) do {} while (false)
+#endif